@@ -1,6 +1,229 @@
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define HAVE_IO_URING 1
+#endif
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Default size of the user-space write buffer
+#define WRITE_BUFFER_SIZE (1 << 20)
+// Alignment O_DIRECT needs for buffers, offsets and lengths
+#define DIRECT_ALIGNMENT 4096
+
+// Block size of the read() fallback
+#define READ_BLOCK_SIZE (1 << 20)
+
+// Queue depth and worker count of the async engine
+#define ASYNC_DEPTH 256
+#define ASYNC_THREADS 16
+// Files a copy/cat/append command keeps in flight, and their chunk size
+#define ASYNC_ACTIVE_FILES 64
+#define ASYNC_CHUNK (128 * 1024)
+
+// Line index sidecar: "<file>.idx" holds a LineIndexHeader followed by
+// the start offset of every line as a native uint64_t
+#define LINE_INDEX_SUFFIX ".idx"
+#define LINE_INDEX_MAGIC "LIDX"
+#define LINE_INDEX_VERSION 2
+// Bytes at each end of the indexed extent the sidecar checksums
+#define LINE_INDEX_CHECK_BYTES 4096
+
+// Default worker count of batch mode and size of its filler pattern
+#define BATCH_THREADS 8
+#define BATCH_FILL_CHUNK (64 * 1024)
+
+// Follow mode: read size, poll interval without inotify, and how often
+// to re-check the file even with inotify
+#define FOLLOW_BUFFER_SIZE (64 * 1024)
+#define FOLLOW_POLL_MS 50
+#define FOLLOW_CHECK_MS 1000
+
+// Writer flags
+#define WRITER_APPEND 0x1      // append instead of truncating
+#define WRITER_DIRECT 0x2      // bypass the page cache with O_DIRECT
+#define WRITER_PREALLOCATE 0x4 // reserve expectedSize bytes up front
+
+// Buffered writer: small writes are collected in a user-space buffer,
+// large ones go out together with the buffered bytes in one writev()
+typedef struct {
+    int fd;
+    int flags;
+    char* buffer;
+    size_t capacity;
+    size_t used;
+} FileWriter;
+
+// How copyFile moved the bytes
+typedef enum {
+    COPY_SENDFILE,
+    COPY_SPLICE,
+    COPY_READ
+} CopyMethod;
+
+// Read-only mapping of a whole file
+typedef struct {
+    const char* data;
+    size_t length;
+} MappedFile;
+
+// When the append log syncs written records to disk
+typedef enum {
+    DURABILITY_NONE,   // never; the page cache decides
+    DURABILITY_BATCH,  // one fdatasync per group of records
+    DURABILITY_RECORD  // one fdatasync per record
+} Durability;
+
+// Record queued by an appender; lives on the appender's stack until the
+// writer thread marks it done
+typedef struct LogRecord {
+    struct LogRecord* next;
+    const void* data;
+    size_t length;
+    long long offset;
+    unsigned long long sequence;
+    int done;
+    int error;
+} LogRecord;
+
+// Group-commit append log: producers push onto a lock-free stack, a single
+// writer thread drains it, writes each group with one writev() and syncs
+// according to the durability mode
+typedef struct {
+    int fd;
+    Durability durability;
+    LogRecord* pending;         // MPSC stack, newest first
+    pthread_mutex_t lock;
+    pthread_cond_t wakeWriter;
+    pthread_cond_t committed;
+    pthread_t writer;
+    int closing;
+    long long size;             // end of the log as seen by the writer
+    unsigned long long nextSequence;
+    unsigned long long batches;
+    unsigned long long syncs;
+} AppendLog;
+
+// Kinds of asynchronous operation
+typedef enum {
+    ASYNC_OPEN,
+    ASYNC_READ,
+    ASYNC_WRITE,
+    ASYNC_FSYNC,
+    ASYNC_CLOSE
+} AsyncOpType;
+
+typedef struct AsyncOp AsyncOp;
+
+// Completion callback; result is the syscall's return value or -errno
+typedef void (*AsyncCallback)(AsyncOp* op, long result);
+
+// One queued operation. The caller owns it until its callback has run,
+// and the callback may submit follow-up operations.
+struct AsyncOp {
+    AsyncOpType type;
+    int fd;
+    const char* path;   // ASYNC_OPEN
+    int flags;          // ASYNC_OPEN
+    void* buffer;       // ASYNC_READ / ASYNC_WRITE
+    size_t length;
+    off_t offset;       // -1 uses the file position
+    AsyncCallback callback;
+    void* context;
+    AsyncOp* next;      // engine queues
+    long result;
+};
+
+// Async engine: io_uring where the kernel offers it, otherwise a pool of
+// threads issuing the same syscalls. Callbacks always run in asyncWait.
+typedef struct {
+    int useRing;
+    unsigned depth;
+    unsigned inflight;
+    AsyncOp* backlog;   // submitted while depth operations were in flight
+    AsyncOp* backlogTail;
+    unsigned long long completedOps;
+#ifdef HAVE_IO_URING
+    int ringFd;
+    unsigned toSubmit;
+    void* sqRing;
+    size_t sqRingSize;
+    void* cqRing;
+    size_t cqRingSize;
+    struct io_uring_sqe* sqes;
+    size_t sqesSize;
+    unsigned* sqTail;
+    unsigned* sqMask;
+    unsigned* sqArray;
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned* cqMask;
+    struct io_uring_cqe* cqes;
+#endif
+    pthread_t* workers;
+    int threadCount;
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_cond_t done;
+    AsyncOp* queue;
+    AsyncOp* queueTail;
+    AsyncOp* completed;
+    int stopping;
+} AsyncEngine;
+
+// Header of a line index sidecar
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint64_t indexedSize;   // bytes of the file the entries cover
+    uint64_t entryCount;    // line starts, the first one always 0
+    // Identity of the indexed file: a rewrite in place keeps the inode
+    // but changes the mtime and, unless it is byte-identical at both
+    // ends of the extent, the checksum
+    uint64_t device;
+    uint64_t inode;
+    int64_t mtimeSeconds;
+    int64_t mtimeNanoseconds;
+    uint64_t checksum;      // FNV-1a of the extent's first and last bytes
+} LineIndexHeader;
+
+// State of a follow session
+typedef struct {
+    const char* path;
+    int fd;
+    dev_t device;           // identity of the file being read, to spot rotation
+    ino_t inode;
+    off_t offset;           // next byte to print
+    int notifyFd;           // -1 when polling
+    int fileWatch;
+    char* buffer;
+    unsigned long long bytes;
+    unsigned long long reads;
+} Follower;
 
 // Function prototypes
 void createFile();
@@ -8,10 +231,38 @@ void writeToFile();
 void readFromFile();
 void appendToFile();
 void displayMenu();
+FileWriter* openWriter(const char* filename, int flags, size_t bufferSize, off_t expectedSize);
+int writerWrite(FileWriter* writer, const void* data, size_t length);
+int writerWritev(FileWriter* writer, const struct iovec* iov, int iovcnt);
+int writerFlush(FileWriter* writer);
+int closeWriter(FileWriter* writer);
+int writeBuffer(const char* filename, int flags, const void* data, size_t length);
+long long copyFile(int inFd, int outFd, CopyMethod* method);
+int mapFile(const char* filename, MappedFile* mapped);
+void unmapFile(MappedFile* mapped);
+AppendLog* openAppendLog(const char* filename, Durability durability);
+long long logAppend(AppendLog* log, const void* data, size_t length, unsigned long long* sequence);
+int closeAppendLog(AppendLog* log);
+AsyncEngine* asyncCreate(unsigned depth, int threads);
+void asyncSubmit(AsyncEngine* engine, AsyncOp* op);
+int asyncWait(AsyncEngine* engine);
+unsigned asyncPending(AsyncEngine* engine);
+const char* asyncBackendName(AsyncEngine* engine);
+void asyncDestroy(AsyncEngine* engine);
+int updateLineIndex(const char* filename, int create);
+ssize_t readLines(const char* filename, long long first, long long count, char** lines);
+void readLinesFromFile();
+int followFile(const char* filename, off_t offset, int stopOnInput);
+void followFromFile();
+int runCommand(int argc, char* argv[]);
 
-int main() {
+int main(int argc, char* argv[]) {
     int choice;
     
+    if(argc > 1) {
+        return runCommand(argc, argv);
+    }
+    
     printf("=== File Operations Program ===\n");
     
     do {
@@ -34,18 +285,24 @@ int main() {
                 appendToFile();
                 break;
             case 5:
+                readLinesFromFile();
+                break;
+            case 6:
+                followFromFile();
+                break;
+            case 7:
                 printf("Exiting program. Goodbye!\n");
                 break;
             default:
                 printf("Invalid choice! Please try again.\n");
         }
         
-        if(choice != 5) {
+        if(choice != 7) {
             printf("\nPress Enter to continue...");
             getchar();
         }
         
-    } while(choice != 5);
+    } while(choice != 7);
     
     return 0;
 }
@@ -56,7 +313,9 @@ void displayMenu() {
     printf("2. Write to file\n");
     printf("3. Read from file\n");
     printf("4. Append to file\n");
-    printf("5. Exit\n");
+    printf("5. Read lines from file\n");
+    printf("6. Follow file\n");
+    printf("7. Exit\n");
 }
 
 void createFile() {
@@ -78,95 +337,2406 @@ void createFile() {
     fclose(file);
 }
 
+// Open a buffered writer. bufferSize 0 picks WRITE_BUFFER_SIZE; with
+// WRITER_PREALLOCATE, expectedSize bytes are reserved without changing
+// the file size. O_DIRECT is dropped silently where it is not supported.
+FileWriter* openWriter(const char* filename, int flags, size_t bufferSize, off_t expectedSize) {
+    int openFlags = O_WRONLY | O_CREAT | ((flags & WRITER_APPEND) ? O_APPEND : O_TRUNC);
+    FileWriter* writer = calloc(1, sizeof(FileWriter));
+    
+    if(writer == NULL) {
+        return NULL;
+    }
+    if(bufferSize == 0) {
+        bufferSize = WRITE_BUFFER_SIZE;
+    }
+    
+    // Appending starts at an unaligned offset, which O_DIRECT cannot write
+    if(flags & WRITER_APPEND) {
+        flags &= ~WRITER_DIRECT;
+    }
+    writer->fd = -1;
+    if(flags & WRITER_DIRECT) {
+        bufferSize = (bufferSize + DIRECT_ALIGNMENT - 1) / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+        writer->fd = open(filename, openFlags | O_DIRECT, 0644);
+        if(writer->fd < 0) {
+            flags &= ~WRITER_DIRECT;
+        }
+    }
+    if(writer->fd < 0) {
+        writer->fd = open(filename, openFlags, 0644);
+    }
+    if(writer->fd < 0 || posix_memalign((void**)&writer->buffer, DIRECT_ALIGNMENT, bufferSize) != 0) {
+        int saved = errno;
+        if(writer->fd >= 0) {
+            close(writer->fd);
+        }
+        free(writer);
+        errno = saved;
+        return NULL;
+    }
+    writer->flags = flags;
+    writer->capacity = bufferSize;
+    
+    if((flags & WRITER_PREALLOCATE) && expectedSize > 0) {
+        off_t start = lseek(writer->fd, 0, SEEK_END);
+        // Best effort: the writes below work the same without it
+        if(fallocate(writer->fd, FALLOC_FL_KEEP_SIZE, start, expectedSize) != 0) {
+            posix_fallocate(writer->fd, start, expectedSize);
+        }
+    }
+    return writer;
+}
+
+// Issue writev() until every iovec has been written
+static int writevAll(int fd, struct iovec* iov, int iovcnt) {
+    while(iovcnt > 0) {
+        ssize_t written = writev(fd, iov, iovcnt);
+        if(written < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        while(iovcnt > 0 && (size_t)written >= iov->iov_len) {
+            written -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if(iovcnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + written;
+            iov->iov_len -= (size_t)written;
+        }
+    }
+    return 0;
+}
+
+// Write out whole O_DIRECT blocks of the buffer, keeping the unaligned tail
+static int flushDirect(FileWriter* writer) {
+    size_t aligned = writer->used / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+    struct iovec iov = { writer->buffer, aligned };
+    
+    if(aligned == 0) {
+        return 0;
+    }
+    if(writevAll(writer->fd, &iov, 1) != 0) {
+        return -1;
+    }
+    memmove(writer->buffer, writer->buffer + aligned, writer->used - aligned);
+    writer->used -= aligned;
+    return 0;
+}
+
+// Queue a batch of buffers. Small batches are copied into the buffer;
+// otherwise the buffered bytes and the batch leave in one writev() call.
+int writerWritev(FileWriter* writer, const struct iovec* iov, int iovcnt) {
+    size_t total = 0;
+    for(int i = 0; i < iovcnt; i++) {
+        total += iov[i].iov_len;
+    }
+    
+    if(writer->used + total <= writer->capacity || (writer->flags & WRITER_DIRECT)) {
+        // O_DIRECT data always goes through the aligned buffer
+        for(int i = 0; i < iovcnt; i++) {
+            const char* data = iov[i].iov_base;
+            size_t length = iov[i].iov_len;
+            while(length > 0) {
+                size_t chunk = writer->capacity - writer->used;
+                if(chunk > length) {
+                    chunk = length;
+                }
+                memcpy(writer->buffer + writer->used, data, chunk);
+                writer->used += chunk;
+                data += chunk;
+                length -= chunk;
+                if(writer->used == writer->capacity && writerFlush(writer) != 0) {
+                    return -1;
+                }
+            }
+        }
+        return 0;
+    }
+    
+    struct iovec batch[IOV_MAX];
+    int count = 0;
+    if(writer->used > 0) {
+        batch[count].iov_base = writer->buffer;
+        batch[count].iov_len = writer->used;
+        count++;
+    }
+    for(int i = 0; i < iovcnt; i++) {
+        if(count == IOV_MAX) {
+            if(writevAll(writer->fd, batch, count) != 0) {
+                return -1;
+            }
+            count = 0;
+        }
+        batch[count++] = iov[i];
+    }
+    writer->used = 0;
+    return writevAll(writer->fd, batch, count);
+}
+
+// Queue one buffer
+int writerWrite(FileWriter* writer, const void* data, size_t length) {
+    struct iovec iov = { (void*)data, length };
+    return writerWritev(writer, &iov, 1);
+}
+
+// Push the buffered bytes to the file
+int writerFlush(FileWriter* writer) {
+    if(writer->flags & WRITER_DIRECT) {
+        return flushDirect(writer);
+    }
+    struct iovec iov = { writer->buffer, writer->used };
+    if(writer->used > 0 && writevAll(writer->fd, &iov, 1) != 0) {
+        return -1;
+    }
+    writer->used = 0;
+    return 0;
+}
+
+// Flush, close and free the writer; returns 0 if every byte was written
+int closeWriter(FileWriter* writer) {
+    int result = writerFlush(writer);
+    
+    // The last partial block cannot be written with O_DIRECT
+    if(result == 0 && writer->used > 0) {
+        int fdFlags = fcntl(writer->fd, F_GETFL);
+        struct iovec iov = { writer->buffer, writer->used };
+        if(fcntl(writer->fd, F_SETFL, fdFlags & ~O_DIRECT) != 0 || writevAll(writer->fd, &iov, 1) != 0) {
+            result = -1;
+        }
+    }
+    if(close(writer->fd) != 0) {
+        result = -1;
+    }
+    free(writer->buffer);
+    free(writer);
+    return result;
+}
+
+// Write a whole payload to a file in one go
+int writeBuffer(const char* filename, int flags, const void* data, size_t length) {
+    FileWriter* writer = openWriter(filename, flags, 0, (off_t)length);
+    if(writer == NULL) {
+        return -1;
+    }
+    int result = writerWrite(writer, data, length);
+    if(closeWriter(writer) != 0) {
+        result = -1;
+    }
+    return result;
+}
+
+// Copy lines from stdin to the writer until an empty line
+static int writeLinesUntilBlank(FileWriter* writer) {
+    char* line = NULL;
+    size_t size = 0;
+    ssize_t length;
+    int result = 0;
+    
+    while((length = getline(&line, &size, stdin)) > 0) {
+        // Check if user pressed Enter twice (empty line)
+        if(length == 1 && line[0] == '\n') {
+            break;
+        }
+        if(writerWrite(writer, line, (size_t)length) != 0) {
+            result = -1;
+            break;
+        }
+    }
+    free(line);
+    return result;
+}
+
 void writeToFile() {
     char filename[100];
-    char content[1000];
-    FILE *file;
+    FileWriter* writer;
     
     printf("\nEnter filename to write to: ");
     fgets(filename, sizeof(filename), stdin);
     filename[strcspn(filename, "\n")] = 0; // Remove newline
     
-    file = fopen(filename, "w");
+    writer = openWriter(filename, 0, 0, 0);
     
-    if(file == NULL) {
+    if(writer == NULL) {
         printf("Error: Could not open file '%s' for writing\n", filename);
         return;
     }
     
     printf("Enter content to write (press Enter twice to finish):\n");
     
-    while(1) {
-        fgets(content, sizeof(content), stdin);
+    int failed = writeLinesUntilBlank(writer);
+    if(closeWriter(writer) != 0 || failed) {
+        printf("Error: Could not write to file '%s': %s\n", filename, strerror(errno));
+        return;
+    }
+    printf("Content written to file '%s' successfully!\n", filename);
+}
+
+// Write a group of records (oldest first) and mark them done
+static void commitRecords(AppendLog* log, LogRecord* first) {
+    struct iovec iov[IOV_MAX];
+    LogRecord* record = first;
+    
+    while(record != NULL) {
+        LogRecord* groupStart = record;
+        int count = 0, error = 0;
+        int limit = log->durability == DURABILITY_RECORD ? 1 : IOV_MAX;
         
-        // Check if user pressed Enter twice (empty line)
-        if(strlen(content) == 1 && content[0] == '\n') {
+        while(record != NULL && count < limit) {
+            record->sequence = log->nextSequence++;
+            iov[count].iov_base = (void*)record->data;
+            iov[count].iov_len = record->length;
+            count++;
+            record = record->next;
+        }
+        if(writevAll(log->fd, iov, count) != 0) {
+            // Part of the group may have landed; the file size is the
+            // only reliable end for the records that follow
+            struct stat info;
+            error = errno;
+            if(fstat(log->fd, &info) == 0) {
+                log->size = info.st_size;
+            }
+        } else {
+            // Offsets are handed out only for bytes that reached the file
+            for(LogRecord* r = groupStart; r != record; r = r->next) {
+                r->offset = log->size;
+                log->size += (long long)r->length;
+            }
+            if(log->durability != DURABILITY_NONE) {
+                if(fdatasync(log->fd) != 0) {
+                    error = errno;
+                }
+                log->syncs++;
+            }
+        }
+        for(LogRecord* r = groupStart; r != record; r = r->next) {
+            r->error = error;
+        }
+    }
+    log->batches++;
+    
+    pthread_mutex_lock(&log->lock);
+    for(record = first; record != NULL; ) {
+        // An appender may return as soon as done is set, so read next first
+        LogRecord* next = record->next;
+        record->done = 1;
+        record = next;
+    }
+    pthread_cond_broadcast(&log->committed);
+    pthread_mutex_unlock(&log->lock);
+}
+
+// Writer thread: take everything queued so far and commit it as one group
+static void* appendLogWriter(void* arg) {
+    AppendLog* log = arg;
+    
+    for(;;) {
+        pthread_mutex_lock(&log->lock);
+        while(__atomic_load_n(&log->pending, __ATOMIC_ACQUIRE) == NULL && !log->closing) {
+            pthread_cond_wait(&log->wakeWriter, &log->lock);
+        }
+        pthread_mutex_unlock(&log->lock);
+        
+        LogRecord* stack = __atomic_exchange_n(&log->pending, NULL, __ATOMIC_ACQUIRE);
+        if(stack == NULL) {
+            break; // closing and drained
+        }
+        
+        // The stack is newest first; reverse it into arrival order
+        LogRecord* ordered = NULL;
+        while(stack != NULL) {
+            LogRecord* next = stack->next;
+            stack->next = ordered;
+            ordered = stack;
+            stack = next;
+        }
+        commitRecords(log, ordered);
+    }
+    return NULL;
+}
+
+// Open (or create) a log file for group-committed appends
+AppendLog* openAppendLog(const char* filename, Durability durability) {
+    AppendLog* log = calloc(1, sizeof(AppendLog));
+    struct stat info;
+    
+    if(log == NULL) {
+        return NULL;
+    }
+    log->fd = open(filename, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if(log->fd < 0 || fstat(log->fd, &info) != 0) {
+        int saved = errno;
+        if(log->fd >= 0) {
+            close(log->fd);
+        }
+        free(log);
+        errno = saved;
+        return NULL;
+    }
+    log->durability = durability;
+    log->size = info.st_size;
+    pthread_mutex_init(&log->lock, NULL);
+    pthread_cond_init(&log->wakeWriter, NULL);
+    pthread_cond_init(&log->committed, NULL);
+    if(pthread_create(&log->writer, NULL, appendLogWriter, log) != 0) {
+        pthread_cond_destroy(&log->committed);
+        pthread_cond_destroy(&log->wakeWriter);
+        pthread_mutex_destroy(&log->lock);
+        close(log->fd);
+        free(log);
+        errno = EAGAIN;
+        return NULL;
+    }
+    return log;
+}
+
+// Append one record atomically with respect to other logAppend callers.
+// Blocks until the record is written (and synced, unless DURABILITY_NONE).
+// Returns the record's file offset, or -1 with errno set.
+long long logAppend(AppendLog* log, const void* data, size_t length, unsigned long long* sequence) {
+    LogRecord record = { NULL, data, length, 0, 0, 0, 0 };
+    LogRecord* head = __atomic_load_n(&log->pending, __ATOMIC_RELAXED);
+    
+    do {
+        record.next = head;
+    } while(!__atomic_compare_exchange_n(&log->pending, &head, &record, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    
+    pthread_mutex_lock(&log->lock);
+    // Only the push onto an empty stack needs to wake the writer
+    if(head == NULL) {
+        pthread_cond_signal(&log->wakeWriter);
+    }
+    while(!record.done) {
+        pthread_cond_wait(&log->committed, &log->lock);
+    }
+    pthread_mutex_unlock(&log->lock);
+    
+    if(record.error != 0) {
+        errno = record.error;
+        return -1;
+    }
+    if(sequence != NULL) {
+        *sequence = record.sequence;
+    }
+    return record.offset;
+}
+
+// Drain the queue, stop the writer thread and close the file
+int closeAppendLog(AppendLog* log) {
+    int result;
+    
+    pthread_mutex_lock(&log->lock);
+    log->closing = 1;
+    pthread_cond_signal(&log->wakeWriter);
+    pthread_mutex_unlock(&log->lock);
+    pthread_join(log->writer, NULL);
+    
+    result = close(log->fd);
+    pthread_mutex_destroy(&log->lock);
+    pthread_cond_destroy(&log->wakeWriter);
+    pthread_cond_destroy(&log->committed);
+    free(log);
+    return result;
+}
+
+// Run one operation synchronously; used by the thread-pool backend
+static long executeOp(AsyncOp* op) {
+    long result = -1;
+    
+    switch(op->type) {
+        case ASYNC_OPEN:
+            result = openat(AT_FDCWD, op->path, op->flags, 0644);
+            break;
+        case ASYNC_READ:
+            result = op->offset < 0 ? read(op->fd, op->buffer, op->length)
+                                    : pread(op->fd, op->buffer, op->length, op->offset);
+            break;
+        case ASYNC_WRITE:
+            result = op->offset < 0 ? write(op->fd, op->buffer, op->length)
+                                    : pwrite(op->fd, op->buffer, op->length, op->offset);
+            break;
+        case ASYNC_FSYNC:
+            result = fsync(op->fd);
             break;
+        case ASYNC_CLOSE:
+            result = close(op->fd);
+            break;
+    }
+    return result < 0 ? -errno : result;
+}
+
+// Pool worker: run queued operations and hand them back as completed
+static void* asyncWorker(void* arg) {
+    AsyncEngine* engine = arg;
+    
+    pthread_mutex_lock(&engine->lock);
+    for(;;) {
+        while(engine->queue == NULL && !engine->stopping) {
+            pthread_cond_wait(&engine->work, &engine->lock);
+        }
+        if(engine->queue == NULL) {
+            break;
+        }
+        AsyncOp* op = engine->queue;
+        engine->queue = op->next;
+        if(engine->queue == NULL) {
+            engine->queueTail = NULL;
         }
+        pthread_mutex_unlock(&engine->lock);
         
-        fprintf(file, "%s", content);
+        op->result = executeOp(op);
+        
+        pthread_mutex_lock(&engine->lock);
+        op->next = engine->completed;
+        engine->completed = op;
+        pthread_cond_signal(&engine->done);
     }
+    pthread_mutex_unlock(&engine->lock);
+    return NULL;
+}
+
+#ifdef HAVE_IO_URING
+// Ask the kernel whether the ring supports every opcode ringPrepare uses.
+// Kernels without IORING_REGISTER_PROBE predate IORING_OP_OPENAT anyway.
+static int ringSupportsOps(int ringFd) {
+    static const int needed[] = {
+        IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_FSYNC, IORING_OP_CLOSE
+    };
+    size_t size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe* probe = calloc(1, size);
+    int supported = 0;
     
-    fclose(file);
-    printf("Content written to file '%s' successfully!\n", filename);
+    if(probe == NULL) {
+        return 0;
+    }
+    if(syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, 256) == 0) {
+        supported = 1;
+        for(size_t i = 0; i < sizeof(needed) / sizeof(needed[0]); i++) {
+            if(needed[i] > probe->last_op || !(probe->ops[needed[i]].flags & IO_URING_OP_SUPPORTED)) {
+                supported = 0;
+            }
+        }
+    }
+    free(probe);
+    return supported;
 }
 
-void readFromFile() {
-    char filename[100];
-    char buffer[1000];
-    FILE *file;
+// Map the submission and completion rings of a new io_uring instance
+static int ringSetup(AsyncEngine* engine, unsigned depth) {
+    struct io_uring_params params;
     
-    printf("\nEnter filename to read from: ");
-    fgets(filename, sizeof(filename), stdin);
-    filename[strcspn(filename, "\n")] = 0; // Remove newline
+    memset(&params, 0, sizeof(params));
+    engine->ringFd = (int)syscall(__NR_io_uring_setup, depth, &params);
+    if(engine->ringFd < 0) {
+        return -1;
+    }
+    if(!ringSupportsOps(engine->ringFd)) {
+        close(engine->ringFd);
+        return -1;
+    }
     
-    file = fopen(filename, "r");
+    engine->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    engine->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if(params.features & IORING_FEAT_SINGLE_MMAP) {
+        if(engine->cqRingSize > engine->sqRingSize) {
+            engine->sqRingSize = engine->cqRingSize;
+        }
+        engine->cqRingSize = engine->sqRingSize;
+    }
+    engine->sqRing = mmap(NULL, engine->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          engine->ringFd, IORING_OFF_SQ_RING);
+    if(engine->sqRing == MAP_FAILED) {
+        close(engine->ringFd);
+        return -1;
+    }
+    if(params.features & IORING_FEAT_SINGLE_MMAP) {
+        engine->cqRing = engine->sqRing;
+    } else {
+        engine->cqRing = mmap(NULL, engine->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              engine->ringFd, IORING_OFF_CQ_RING);
+        if(engine->cqRing == MAP_FAILED) {
+            munmap(engine->sqRing, engine->sqRingSize);
+            close(engine->ringFd);
+            return -1;
+        }
+    }
+    engine->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    engine->sqes = mmap(NULL, engine->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        engine->ringFd, IORING_OFF_SQES);
+    if(engine->sqes == MAP_FAILED) {
+        if(engine->cqRing != engine->sqRing) {
+            munmap(engine->cqRing, engine->cqRingSize);
+        }
+        munmap(engine->sqRing, engine->sqRingSize);
+        close(engine->ringFd);
+        return -1;
+    }
     
-    if(file == NULL) {
-        printf("Error: Could not open file '%s' for reading\n", filename);
-        printf("Make sure the file exists!\n");
-        return;
+    engine->sqTail = (unsigned*)((char*)engine->sqRing + params.sq_off.tail);
+    engine->sqMask = (unsigned*)((char*)engine->sqRing + params.sq_off.ring_mask);
+    engine->sqArray = (unsigned*)((char*)engine->sqRing + params.sq_off.array);
+    engine->cqHead = (unsigned*)((char*)engine->cqRing + params.cq_off.head);
+    engine->cqTail = (unsigned*)((char*)engine->cqRing + params.cq_off.tail);
+    engine->cqMask = (unsigned*)((char*)engine->cqRing + params.cq_off.ring_mask);
+    engine->cqes = (struct io_uring_cqe*)((char*)engine->cqRing + params.cq_off.cqes);
+    engine->depth = params.sq_entries;
+    return 0;
+}
+
+// Fill the next submission queue entry; io_uring_enter sends it later
+static void ringPrepare(AsyncEngine* engine, AsyncOp* op) {
+    unsigned tail = *engine->sqTail;
+    unsigned index = tail & *engine->sqMask;
+    struct io_uring_sqe* sqe = &engine->sqes[index];
+    
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = op->fd;
+    sqe->user_data = (unsigned long long)(uintptr_t)op;
+    switch(op->type) {
+        case ASYNC_OPEN:
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (unsigned long long)(uintptr_t)op->path;
+            sqe->len = 0644;
+            sqe->open_flags = (unsigned)op->flags;
+            break;
+        case ASYNC_READ:
+        case ASYNC_WRITE:
+            sqe->opcode = op->type == ASYNC_READ ? IORING_OP_READ : IORING_OP_WRITE;
+            sqe->addr = (unsigned long long)(uintptr_t)op->buffer;
+            sqe->len = (unsigned)op->length;
+            sqe->off = (unsigned long long)(long long)op->offset;
+            break;
+        case ASYNC_FSYNC:
+            sqe->opcode = IORING_OP_FSYNC;
+            break;
+        case ASYNC_CLOSE:
+            sqe->opcode = IORING_OP_CLOSE;
+            break;
+    }
+    engine->sqArray[index] = index;
+    __atomic_store_n(engine->sqTail, tail + 1, __ATOMIC_RELEASE);
+    engine->toSubmit++;
+}
+
+// Submit prepared entries, wait for at least one completion and collect
+// everything that has completed into *done
+static int ringReap(AsyncEngine* engine, AsyncOp** done) {
+    for(;;) {
+        long entered = syscall(__NR_io_uring_enter, engine->ringFd, engine->toSubmit, 1,
+                               IORING_ENTER_GETEVENTS, NULL, 0);
+        if(entered >= 0) {
+            engine->toSubmit -= (unsigned)entered;
+            break;
+        }
+        if(errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            return -1;
+        }
     }
     
-    printf("\n--- Content of file '%s' ---\n", filename);
+    unsigned head = *engine->cqHead;
+    unsigned tail = __atomic_load_n(engine->cqTail, __ATOMIC_ACQUIRE);
+    while(head != tail) {
+        struct io_uring_cqe* cqe = &engine->cqes[head & *engine->cqMask];
+        AsyncOp* op = (AsyncOp*)(uintptr_t)cqe->user_data;
+        op->result = cqe->res;
+        op->next = *done;
+        *done = op;
+        head++;
+    }
+    __atomic_store_n(engine->cqHead, head, __ATOMIC_RELEASE);
+    return 0;
+}
+#endif
+
+// Start an engine with room for depth operations in flight. threads > 0
+// forces the thread-pool backend with that many workers.
+AsyncEngine* asyncCreate(unsigned depth, int threads) {
+    AsyncEngine* engine = calloc(1, sizeof(AsyncEngine));
     
-    while(fgets(buffer, sizeof(buffer), file) != NULL) {
-        printf("%s", buffer);
+    if(engine == NULL) {
+        return NULL;
     }
+    engine->depth = depth;
+#ifdef HAVE_IO_URING
+    if(threads <= 0 && ringSetup(engine, depth) == 0) {
+        engine->useRing = 1;
+        return engine;
+    }
+#endif
     
-    fclose(file);
-    printf("\n--- End of file ---\n");
+    engine->threadCount = threads > 0 ? threads : ASYNC_THREADS;
+    engine->workers = malloc(sizeof(pthread_t) * engine->threadCount);
+    if(engine->workers == NULL) {
+        free(engine);
+        return NULL;
+    }
+    pthread_mutex_init(&engine->lock, NULL);
+    pthread_cond_init(&engine->work, NULL);
+    pthread_cond_init(&engine->done, NULL);
+    for(int i = 0; i < engine->threadCount; i++) {
+        if(pthread_create(&engine->workers[i], NULL, asyncWorker, engine) != 0) {
+            engine->threadCount = i;
+            break;
+        }
+    }
+    if(engine->threadCount == 0) {
+        asyncDestroy(engine);
+        return NULL;
+    }
+    return engine;
 }
 
-void appendToFile() {
-    char filename[100];
-    char content[1000];
-    FILE *file;
+// Hand an operation to the backend
+static void asyncDispatch(AsyncEngine* engine, AsyncOp* op) {
+    engine->inflight++;
+#ifdef HAVE_IO_URING
+    if(engine->useRing) {
+        ringPrepare(engine, op);
+        return;
+    }
+#endif
+    op->next = NULL;
+    pthread_mutex_lock(&engine->lock);
+    if(engine->queueTail != NULL) {
+        engine->queueTail->next = op;
+    } else {
+        engine->queue = op;
+    }
+    engine->queueTail = op;
+    pthread_cond_signal(&engine->work);
+    pthread_mutex_unlock(&engine->lock);
+}
+
+// Queue an operation; it starts once fewer than depth are in flight
+void asyncSubmit(AsyncEngine* engine, AsyncOp* op) {
+    if(engine->backlog == NULL && engine->inflight < engine->depth) {
+        asyncDispatch(engine, op);
+        return;
+    }
+    op->next = NULL;
+    if(engine->backlogTail != NULL) {
+        engine->backlogTail->next = op;
+    } else {
+        engine->backlog = op;
+    }
+    engine->backlogTail = op;
+}
+
+// Operations submitted but not yet completed
+unsigned asyncPending(AsyncEngine* engine) {
+    unsigned pending = engine->inflight;
+    for(AsyncOp* op = engine->backlog; op != NULL; op = op->next) {
+        pending++;
+    }
+    return pending;
+}
+
+// Wait for completions and run their callbacks. Returns how many
+// operations completed, or -1 if the ring failed.
+int asyncWait(AsyncEngine* engine) {
+    AsyncOp* done = NULL;
+    int count = 0;
     
-    printf("\nEnter filename to append to: ");
-    fgets(filename, sizeof(filename), stdin);
-    filename[strcspn(filename, "\n")] = 0; // Remove newline
+    if(engine->inflight == 0 && engine->backlog == NULL) {
+        return 0;
+    }
+#ifdef HAVE_IO_URING
+    if(engine->useRing && ringReap(engine, &done) != 0) {
+        return -1;
+    }
+#endif
+    if(!engine->useRing) {
+        pthread_mutex_lock(&engine->lock);
+        while(engine->completed == NULL) {
+            pthread_cond_wait(&engine->done, &engine->lock);
+        }
+        done = engine->completed;
+        engine->completed = NULL;
+        pthread_mutex_unlock(&engine->lock);
+    }
     
-    file = fopen(filename, "a");
+    for(AsyncOp* op = done; op != NULL; op = op->next) {
+        engine->inflight--;
+        count++;
+    }
+    engine->completedOps += (unsigned long long)count;
+    while(done != NULL) {
+        AsyncOp* next = done->next;
+        done->callback(done, done->result);
+        done = next;
+    }
     
-    if(file == NULL) {
-        printf("Error: Could not open file '%s' for appending\n", filename);
+    // Start what the callbacks and earlier submitters left waiting
+    while(engine->backlog != NULL && engine->inflight < engine->depth) {
+        AsyncOp* op = engine->backlog;
+        engine->backlog = op->next;
+        if(engine->backlog == NULL) {
+            engine->backlogTail = NULL;
+        }
+        asyncDispatch(engine, op);
+    }
+    return count;
+}
+
+// Name of the backend in use
+const char* asyncBackendName(AsyncEngine* engine) {
+    return engine->useRing ? "io_uring" : "thread pool";
+}
+
+// Stop the backend; operations still in flight are abandoned
+void asyncDestroy(AsyncEngine* engine) {
+#ifdef HAVE_IO_URING
+    if(engine->useRing) {
+        munmap(engine->sqes, engine->sqesSize);
+        if(engine->cqRing != engine->sqRing) {
+            munmap(engine->cqRing, engine->cqRingSize);
+        }
+        munmap(engine->sqRing, engine->sqRingSize);
+        close(engine->ringFd);
+        free(engine);
         return;
     }
+#endif
+    pthread_mutex_lock(&engine->lock);
+    engine->stopping = 1;
+    pthread_cond_broadcast(&engine->work);
+    pthread_mutex_unlock(&engine->lock);
+    for(int i = 0; i < engine->threadCount; i++) {
+        pthread_join(engine->workers[i], NULL);
+    }
+    pthread_mutex_destroy(&engine->lock);
+    pthread_cond_destroy(&engine->work);
+    pthread_cond_destroy(&engine->done);
+    free(engine->workers);
+    free(engine);
+}
+
+// Copy from the current offset of inFd to the end of the file into outFd.
+// The kernel moves the bytes with sendfile(), or splice() into a pipe;
+// large read()/write() blocks are the fallback. Returns the byte count or -1.
+long long copyFile(int inFd, int outFd, CopyMethod* method) {
+    struct stat outInfo;
+    long long total = 0;
+    ssize_t moved;
+    char* buffer;
     
-    printf("Enter content to append (press Enter twice to finish):\n");
+    *method = COPY_SENDFILE;
+    while((moved = sendfile(outFd, inFd, NULL, 1 << 30)) > 0) {
+        total += moved;
+    }
+    if(moved == 0) {
+        return total;
+    }
+    if(errno != EINVAL && errno != ENOSYS) {
+        return -1;
+    }
     
-    while(1) {
-        fgets(content, sizeof(content), stdin);
-        
-        // Check if user pressed Enter twice (empty line)
-        if(strlen(content) == 1 && content[0] == '\n') {
-            break;
+    if(fstat(outFd, &outInfo) == 0 && S_ISFIFO(outInfo.st_mode)) {
+        *method = COPY_SPLICE;
+        while((moved = splice(inFd, NULL, outFd, NULL, 1 << 30, SPLICE_F_MOVE)) > 0) {
+            total += moved;
+        }
+        if(moved == 0) {
+            return total;
+        }
+        if(errno != EINVAL && errno != ENOSYS) {
+            return -1;
         }
-        
-        fprintf(file, "%s", content);
     }
     
-    fclose(file);
-    printf("Content appended to file '%s' successfully!\n", filename);
+    *method = COPY_READ;
+    buffer = malloc(READ_BLOCK_SIZE);
+    if(buffer == NULL) {
+        return -1;
+    }
+    while((moved = read(inFd, buffer, READ_BLOCK_SIZE)) != 0) {
+        if(moved < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            total = -1;
+            break;
+        }
+        struct iovec iov = { buffer, (size_t)moved };
+        if(writevAll(outFd, &iov, 1) != 0) {
+            total = -1;
+            break;
+        }
+        total += moved;
+    }
+    free(buffer);
+    return total;
+}
+
+// Map a file read-only for in-process scanning. Empty files map to a
+// NULL pointer with length 0 and need no unmapFile.
+int mapFile(const char* filename, MappedFile* mapped) {
+    struct stat info;
+    int fd = open(filename, O_RDONLY);
+    
+    mapped->data = NULL;
+    mapped->length = 0;
+    if(fd < 0) {
+        return -1;
+    }
+    if(fstat(fd, &info) != 0) {
+        close(fd);
+        return -1;
+    }
+    if(info.st_size > 0) {
+        void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(data == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+        mapped->data = data;
+        mapped->length = (size_t)info.st_size;
+    }
+    close(fd);
+    return 0;
+}
+
+// Release a mapping made by mapFile
+void unmapFile(MappedFile* mapped) {
+    if(mapped->length > 0) {
+        munmap((void*)mapped->data, mapped->length);
+    }
+    mapped->data = NULL;
+    mapped->length = 0;
+}
+
+// Seconds on the monotonic clock
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void readFromFile() {
+    static const char* methodNames[] = { "sendfile", "splice", "read" };
+    char filename[100];
+    CopyMethod method;
+    long long bytes;
+    double start, elapsed;
+    int fd;
+    
+    printf("\nEnter filename to read from: ");
+    fgets(filename, sizeof(filename), stdin);
+    filename[strcspn(filename, "\n")] = 0; // Remove newline
+    
+    fd = open(filename, O_RDONLY);
+    
+    if(fd < 0) {
+        printf("Error: Could not open file '%s' for reading\n", filename);
+        printf("Make sure the file exists!\n");
+        return;
+    }
+    
+    printf("\n--- Content of file '%s' ---\n", filename);
+    fflush(stdout); // The copy bypasses stdio
+    
+    start = nowSeconds();
+    bytes = copyFile(fd, STDOUT_FILENO, &method);
+    elapsed = nowSeconds() - start;
+    close(fd);
+    
+    printf("\n--- End of file ---\n");
+    if(bytes < 0) {
+        printf("Error: Could not read file '%s': %s\n", filename, strerror(errno));
+        return;
+    }
+    printf("Read %lld bytes in %.3f s (%.1f MB/s, %s)\n", bytes, elapsed,
+            elapsed > 0 ? bytes / elapsed / 1e6 : 0.0, methodNames[method]);
+}
+
+// Drop inotify after a watch could not be added (watch limit reached, or
+// a filesystem without inotify support); the loop then polls instead
+static void followStopWatching(Follower* follower) {
+    fprintf(stderr, "\n--- inotify watch failed (%s), polling every %d ms ---\n", strerror(errno), FOLLOW_POLL_MS);
+    close(follower->notifyFd);
+    follower->notifyFd = -1;
+    follower->fileWatch = -1;
+}
+
+// Open the followed path and watch the new inode
+static int followOpen(Follower* follower) {
+    struct stat st;
+    int fd = open(follower->path, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        return -1;
+    }
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if(follower->fd >= 0) {
+        close(follower->fd);
+    }
+    follower->fd = fd;
+    follower->device = st.st_dev;
+    follower->inode = st.st_ino;
+    if(follower->notifyFd >= 0) {
+        if(follower->fileWatch >= 0) {
+            inotify_rm_watch(follower->notifyFd, follower->fileWatch); // gone already if deleted
+        }
+        follower->fileWatch = inotify_add_watch(follower->notifyFd, follower->path,
+                IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+        if(follower->fileWatch < 0) {
+            followStopWatching(follower);
+        }
+    }
+    return 0;
+}
+
+// Copy everything past the saved offset to stdout. A file shorter than
+// the offset was truncated in place and is read again from the start.
+static int followDrain(Follower* follower) {
+    struct stat st;
+    if(fstat(follower->fd, &st) != 0) {
+        return -1;
+    }
+    if(st.st_size < follower->offset) {
+        fprintf(stderr, "\n--- '%s' truncated, reading from the start ---\n", follower->path);
+        follower->offset = 0;
+    }
+    while(1) {
+        ssize_t n = pread(follower->fd, follower->buffer, FOLLOW_BUFFER_SIZE, follower->offset);
+        if(n < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if(n == 0) {
+            return 0;
+        }
+        struct iovec iov = { follower->buffer, (size_t)n };
+        if(writevAll(STDOUT_FILENO, &iov, 1) != 0) {
+            return -1;
+        }
+        follower->offset += n;
+        follower->bytes += (unsigned long long)n;
+        follower->reads++;
+        if(n < FOLLOW_BUFFER_SIZE) {
+            return 0;
+        }
+    }
+}
+
+// Switch to a new file once the path names a different inode (rotation by
+// rename or delete and re-create). The old file is drained first so
+// nothing written before the rotation is lost; while the path is missing
+// the old file keeps being followed.
+static int followCheckRotation(Follower* follower) {
+    struct stat st;
+    if(stat(follower->path, &st) != 0) {
+        return errno == ENOENT ? 0 : -1;
+    }
+    if(st.st_dev == follower->device && st.st_ino == follower->inode) {
+        return 0;
+    }
+    if(followDrain(follower) != 0 || followOpen(follower) != 0) {
+        return -1;
+    }
+    fprintf(stderr, "\n--- '%s' replaced, following the new file ---\n", follower->path);
+    follower->offset = 0;
+    return 0;
+}
+
+// Release everything a follow session holds
+static void followClose(Follower* follower) {
+    if(follower->fd >= 0) {
+        close(follower->fd);
+    }
+    if(follower->notifyFd >= 0) {
+        close(follower->notifyFd);
+    }
+    free(follower->buffer);
+}
+
+// Print new data until an error or, with stopOnInput, a line on stdin
+static int followLoop(Follower* follower, int stopOnInput) {
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    
+    while(1) {
+        struct pollfd fds[2];
+        int count = 0, ready;
+        
+        if(followDrain(follower) != 0) {
+            return -1;
+        }
+        if(follower->notifyFd >= 0) {
+            fds[count].fd = follower->notifyFd;
+            fds[count++].events = POLLIN;
+        }
+        if(stopOnInput) {
+            fds[count].fd = STDIN_FILENO;
+            fds[count++].events = POLLIN;
+        }
+        // With inotify the timeout is only a safety net for filesystems
+        // that do not report changes
+        ready = poll(fds, (nfds_t)count, follower->notifyFd >= 0 ? FOLLOW_CHECK_MS : FOLLOW_POLL_MS);
+        if(ready < 0 && errno != EINTR) {
+            return -1;
+        }
+        if(stopOnInput && ready > 0 && fds[count - 1].revents != 0) {
+            int c;
+            while((c = getchar()) != '\n' && c != EOF) {
+            }
+            return 0;
+        }
+        if(follower->notifyFd >= 0 && ready > 0 && fds[0].revents != 0) {
+            while(read(follower->notifyFd, events, sizeof(events)) > 0) {
+            }
+        }
+        if(followCheckRotation(follower) != 0) {
+            return -1;
+        }
+    }
+}
+
+// Print data appended to a file as it arrives, like tail -f. Starts at
+// offset, or at the current end when offset is negative. Waits on inotify
+// events for the file and its directory, or polls every FOLLOW_POLL_MS
+// when inotify is unavailable or FILE_OP_POLL is set. Runs until an error,
+// or until a line is entered on stdin when stopOnInput is set.
+int followFile(const char* filename, off_t offset, int stopOnInput) {
+    Follower follower = { filename, -1, 0, 0, offset, -1, -1, NULL, 0, 0 };
+    char directory[PATH_MAX];
+    const char* slash = strrchr(filename, '/');
+    int status;
+    
+    if(slash == NULL) {
+        strcpy(directory, ".");
+    } else {
+        snprintf(directory, sizeof(directory), "%.*s", slash == filename ? 1 : (int)(slash - filename), filename);
+    }
+    if(getenv("FILE_OP_POLL") == NULL) {
+        follower.notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+    follower.buffer = malloc(FOLLOW_BUFFER_SIZE);
+    if(follower.buffer == NULL || followOpen(&follower) != 0) {
+        printf("Error: Could not open file '%s' for following: %s\n", filename, strerror(errno));
+        followClose(&follower);
+        return -1;
+    }
+    if(follower.notifyFd >= 0) {
+        // Catches a replacement file appearing under the followed name
+        if(inotify_add_watch(follower.notifyFd, directory, IN_CREATE | IN_MOVED_TO) < 0) {
+            followStopWatching(&follower);
+        }
+    }
+    if(follower.offset < 0) {
+        follower.offset = lseek(follower.fd, 0, SEEK_END);
+    }
+    
+    fprintf(stderr, "--- Following '%s' from offset %lld with %s%s ---\n", filename, (long long)follower.offset,
+            follower.notifyFd >= 0 ? "inotify" : "polling", stopOnInput ? ", press Enter to stop" : "");
+    fflush(stdout); // Output bypasses stdio
+    
+    status = followLoop(&follower, stopOnInput);
+    if(status != 0) {
+        printf("Error: Following file '%s' failed: %s\n", filename, strerror(errno));
+    }
+    fprintf(stderr, "\n--- Stopped following '%s': %llu bytes in %llu reads ---\n", filename,
+            follower.bytes, follower.reads);
+    followClose(&follower);
+    return status;
+}
+
+// Menu entry: print a file and keep printing what gets appended to it
+void followFromFile() {
+    char filename[100];
+    
+    printf("\nEnter filename to follow: ");
+    fgets(filename, sizeof(filename), stdin);
+    filename[strcspn(filename, "\n")] = 0; // Remove newline
+    
+    followFile(filename, 0, 1);
+}
+
+// Collect lines from stdin until an empty line into one malloc'd buffer
+static char* readLinesUntilBlank(size_t* length) {
+    char* content = NULL;
+    FILE* stream = open_memstream(&content, length);
+    char* line = NULL;
+    size_t size = 0;
+    ssize_t lineLength;
+    
+    if(stream == NULL) {
+        return NULL;
+    }
+    while((lineLength = getline(&line, &size, stdin)) > 0) {
+        // Check if user pressed Enter twice (empty line)
+        if(lineLength == 1 && line[0] == '\n') {
+            break;
+        }
+        fwrite(line, 1, (size_t)lineLength, stream);
+    }
+    free(line);
+    fclose(stream);
+    return content;
+}
+
+void appendToFile() {
+    char filename[100];
+    AppendLog* log;
+    char* content;
+    size_t length;
+    long long offset;
+    unsigned long long sequence;
+    
+    printf("\nEnter filename to append to: ");
+    fgets(filename, sizeof(filename), stdin);
+    filename[strcspn(filename, "\n")] = 0; // Remove newline
+    
+    log = openAppendLog(filename, DURABILITY_BATCH);
+    
+    if(log == NULL) {
+        printf("Error: Could not open file '%s' for appending\n", filename);
+        return;
+    }
+    
+    printf("Enter content to append (press Enter twice to finish):\n");
+    
+    // The whole entry goes in as one record so concurrent appenders
+    // cannot interleave with it
+    content = readLinesUntilBlank(&length);
+    offset = content != NULL ? logAppend(log, content, length, &sequence) : -1;
+    free(content);
+    if(closeAppendLog(log) != 0 || offset < 0) {
+        printf("Error: Could not append to file '%s': %s\n", filename, strerror(errno));
+        return;
+    }
+    printf("Content appended to file '%s' at offset %lld successfully!\n", filename, offset);
+    
+    // Keep an existing line index current; files without one are left alone
+    if(updateLineIndex(filename, 0) != 0) {
+        printf("Warning: Could not update the line index of '%s'\n", filename);
+    }
+}
+
+// Path of the line index sidecar of a file
+static void lineIndexPath(const char* filename, char* path, size_t size) {
+    snprintf(path, size, "%s%s", filename, LINE_INDEX_SUFFIX);
+}
+
+// Write the start offset of every line that begins after a newline in
+// data[begin, end); offsets are relative to data
+static int indexNewlines(const char* data, size_t begin, size_t end, FileWriter* sidecar, uint64_t* entries) {
+    uint64_t starts[512];
+    int count = 0;
+    size_t i = begin;
+    
+#ifdef __SSE2__
+    const __m128i newline = _mm_set1_epi8('\n');
+    for(; i + 64 <= end; i += 64) {
+        const __m128i* block = (const __m128i*)(data + i);
+        uint64_t mask = (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(block), newline))
+            | (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(block + 1), newline)) << 16
+            | (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(block + 2), newline)) << 32
+            | (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(block + 3), newline)) << 48;
+        while(mask != 0) {
+            starts[count++] = i + (size_t)__builtin_ctzll(mask) + 1;
+            mask &= mask - 1;
+            if(count == 512) {
+                if(writerWrite(sidecar, starts, sizeof(starts)) != 0) {
+                    return -1;
+                }
+                *entries += (uint64_t)count;
+                count = 0;
+            }
+        }
+    }
+#endif
+    for(; i < end; i++) {
+        if(data[i] != '\n') {
+            continue;
+        }
+        starts[count++] = i + 1;
+        if(count == 512) {
+            if(writerWrite(sidecar, starts, sizeof(starts)) != 0) {
+                return -1;
+            }
+            *entries += (uint64_t)count;
+            count = 0;
+        }
+    }
+    *entries += (uint64_t)count;
+    return writerWrite(sidecar, starts, sizeof(uint64_t) * (size_t)count);
+}
+
+// Read the sidecar header; returns -1 if it is missing or not an index
+static int readLineIndexHeader(int fd, LineIndexHeader* header) {
+    if(pread(fd, header, sizeof(*header), 0) != (ssize_t)sizeof(*header)
+       || memcmp(header->magic, LINE_INDEX_MAGIC, 4) != 0 || header->version != LINE_INDEX_VERSION) {
+        return -1;
+    }
+    return 0;
+}
+
+// Checksum the first and last LINE_INDEX_CHECK_BYTES of an extent
+static uint64_t lineIndexChecksum(const char* data, uint64_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    uint64_t head = size < LINE_INDEX_CHECK_BYTES ? size : LINE_INDEX_CHECK_BYTES;
+    uint64_t tail = size - head < LINE_INDEX_CHECK_BYTES ? size - head : LINE_INDEX_CHECK_BYTES;
+    
+    for(uint64_t i = 0; i < head; i++) {
+        hash = (hash ^ (unsigned char)data[i]) * 1099511628211ull;
+    }
+    for(uint64_t i = size - tail; i < size; i++) {
+        hash = (hash ^ (unsigned char)data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Bring the line index of a file up to date: scan only the bytes added
+// since the last update, or rebuild from scratch if the file shrank, was
+// rewritten or replaced, or the sidecar is unusable. Without create,
+// files lacking a sidecar are skipped.
+int updateLineIndex(const char* filename, int create) {
+    char path[PATH_MAX];
+    LineIndexHeader header;
+    MappedFile mapped;
+    FileWriter* sidecar;
+    struct stat info;
+    int fd, rebuild;
+    
+    lineIndexPath(filename, path, sizeof(path));
+    fd = open(path, O_RDWR);
+    if(fd < 0 && !create) {
+        return errno == ENOENT ? 0 : -1;
+    }
+    if(stat(filename, &info) != 0 || mapFile(filename, &mapped) != 0) {
+        if(fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    
+    rebuild = fd < 0 || readLineIndexHeader(fd, &header) != 0 || header.indexedSize > mapped.length
+              || header.device != (uint64_t)info.st_dev || header.inode != (uint64_t)info.st_ino
+              || header.checksum != lineIndexChecksum(mapped.data, header.indexedSize);
+    int unchanged = !rebuild && header.mtimeSeconds == (int64_t)info.st_mtim.tv_sec
+                    && header.mtimeNanoseconds == (int64_t)info.st_mtim.tv_nsec;
+    // Same size but a newer mtime means the file was rewritten in place
+    if(!rebuild && !unchanged && header.indexedSize == mapped.length) {
+        rebuild = 1;
+    }
+    if(!rebuild && unchanged && header.indexedSize == mapped.length) {
+        close(fd);
+        unmapFile(&mapped);
+        return 0;
+    }
+    if(rebuild) {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, LINE_INDEX_MAGIC, 4);
+        header.version = LINE_INDEX_VERSION;
+        if(fd >= 0) {
+            close(fd);
+        }
+        sidecar = openWriter(path, 0, 0, 0);
+    } else {
+        // Drop entries a failed update may have left past the header's count
+        if(ftruncate(fd, (off_t)(sizeof(header) + header.entryCount * sizeof(uint64_t))) != 0) {
+            close(fd);
+            unmapFile(&mapped);
+            return -1;
+        }
+        sidecar = openWriter(path, WRITER_APPEND, 0, 0);
+    }
+    if(sidecar == NULL) {
+        if(!rebuild) {
+            close(fd);
+        }
+        unmapFile(&mapped);
+        return -1;
+    }
+    
+    int result = 0;
+    uint64_t entries = header.entryCount;
+    if(rebuild) {
+        // Every file starts with line 0. The header is written invalid
+        // and only completed below, once every entry is on disk.
+        LineIndexHeader pending = header;
+        uint64_t first = 0;
+        pending.version = 0;
+        result = writerWrite(sidecar, &pending, sizeof(pending));
+        if(result == 0) {
+            result = writerWrite(sidecar, &first, sizeof(first));
+            entries = 1;
+        }
+    }
+    if(result == 0) {
+        result = indexNewlines(mapped.data, header.indexedSize, mapped.length, sidecar, &entries);
+    }
+    if(closeWriter(sidecar) != 0) {
+        result = -1;
+    }
+    
+    // The header goes last, so a failed update leaves the old extent valid
+    header.indexedSize = mapped.length;
+    header.entryCount = entries;
+    header.device = (uint64_t)info.st_dev;
+    header.inode = (uint64_t)info.st_ino;
+    header.mtimeSeconds = (int64_t)info.st_mtim.tv_sec;
+    header.mtimeNanoseconds = (int64_t)info.st_mtim.tv_nsec;
+    header.checksum = lineIndexChecksum(mapped.data, mapped.length);
+    if(rebuild) {
+        fd = open(path, O_RDWR);
+    }
+    if(result == 0 && (fd < 0 || pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header))) {
+        result = -1;
+    }
+    if(fd >= 0) {
+        close(fd);
+    }
+    unmapFile(&mapped);
+    return result;
+}
+
+// Read lines [first, first + count) of a file (first counts from 0) into a
+// malloc'd buffer, using the line index to pread only that byte range.
+// Returns the number of bytes read, or -1.
+ssize_t readLines(const char* filename, long long first, long long count, char** lines) {
+    char path[PATH_MAX];
+    LineIndexHeader header;
+    uint64_t start, end;
+    long long lineCount;
+    int indexFd, fd;
+    
+    *lines = NULL;
+    if(first < 0 || count < 0 || updateLineIndex(filename, 1) != 0) {
+        return -1;
+    }
+    lineIndexPath(filename, path, sizeof(path));
+    indexFd = open(path, O_RDONLY);
+    if(indexFd < 0 || readLineIndexHeader(indexFd, &header) != 0) {
+        if(indexFd >= 0) {
+            close(indexFd);
+        }
+        return -1;
+    }
+    
+    // A trailing newline leaves an empty entry at the very end of the file
+    lineCount = (long long)header.entryCount;
+    if(lineCount > 0 && header.indexedSize > 0) {
+        uint64_t last;
+        if(pread(indexFd, &last, sizeof(last), sizeof(header) + (lineCount - 1) * sizeof(uint64_t)) == sizeof(last)
+           && last == header.indexedSize) {
+            lineCount--;
+        }
+    } else {
+        lineCount = 0;
+    }
+    if(first >= lineCount) {
+        close(indexFd);
+        *lines = malloc(1);
+        return *lines != NULL ? 0 : -1;
+    }
+    if(count > lineCount - first) {
+        count = lineCount - first;
+    }
+    
+    end = header.indexedSize;
+    if(pread(indexFd, &start, sizeof(start), sizeof(header) + first * sizeof(uint64_t)) != sizeof(start)
+       || (first + count < (long long)header.entryCount
+           && pread(indexFd, &end, sizeof(end), sizeof(header) + (first + count) * sizeof(uint64_t)) != sizeof(end))) {
+        close(indexFd);
+        return -1;
+    }
+    close(indexFd);
+    
+    fd = open(filename, O_RDONLY);
+    *lines = malloc(end - start + 1);
+    if(fd < 0 || *lines == NULL) {
+        if(fd >= 0) {
+            close(fd);
+        }
+        free(*lines);
+        *lines = NULL;
+        return -1;
+    }
+    size_t done = 0;
+    while(done < end - start) {
+        ssize_t got = pread(fd, *lines + done, end - start - done, (off_t)(start + done));
+        if(got <= 0) {
+            if(got < 0 && errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        done += (size_t)got;
+    }
+    close(fd);
+    (*lines)[done] = '\0';
+    return (ssize_t)done;
+}
+
+void readLinesFromFile() {
+    char filename[100];
+    long long first, count;
+    char* lines;
+    ssize_t length;
+    
+    printf("\nEnter filename to read from: ");
+    fgets(filename, sizeof(filename), stdin);
+    filename[strcspn(filename, "\n")] = 0; // Remove newline
+    
+    printf("Enter first line number and line count: ");
+    if(scanf("%lld %lld", &first, &count) != 2 || first < 1 || count < 0) {
+        printf("Error: Invalid line range\n");
+        return;
+    }
+    getchar(); // Clear the newline character from input buffer
+    
+    length = readLines(filename, first - 1, count, &lines);
+    if(length < 0) {
+        printf("Error: Could not read lines from file '%s'\n", filename);
+        return;
+    }
+    
+    printf("\n--- Lines %lld-%lld of file '%s' ---\n", first, first + count - 1, filename);
+    fwrite(lines, 1, (size_t)length, stdout);
+    printf("\n--- End of lines ---\n");
+    free(lines);
+}
+
+// Arguments for one append benchmark thread
+typedef struct {
+    AppendLog* log;
+    int records;
+    int id;
+} AppendBenchThread;
+
+// Append fixed-size records tagged with the thread id
+static void* appendBenchWorker(void* arg) {
+    AppendBenchThread* job = arg;
+    char record[64];
+    
+    for(int i = 0; i < job->records; i++) {
+        int length = snprintf(record, sizeof(record), "thread %3d record %8d\n", job->id, i);
+        if(logAppend(job->log, record, (size_t)length, NULL) < 0) {
+            perror("append");
+            break;
+        }
+    }
+    return NULL;
+}
+
+// Measure durable append throughput with many concurrent appenders
+static int appendBenchmark(const char* filename, int threads, int records, Durability durability) {
+    AppendLog* log = openAppendLog(filename, durability);
+    pthread_t* ids = malloc(sizeof(pthread_t) * threads);
+    AppendBenchThread* jobs = malloc(sizeof(AppendBenchThread) * threads);
+    double start;
+    int started = 0;
+    
+    if(log == NULL || ids == NULL || jobs == NULL) {
+        printf("Error: Could not open file '%s' for appending\n", filename);
+        if(log != NULL) {
+            closeAppendLog(log);
+        }
+        free(ids);
+        free(jobs);
+        return 1;
+    }
+    start = nowSeconds();
+    for(; started < threads; started++) {
+        jobs[started].log = log;
+        jobs[started].records = records;
+        jobs[started].id = started;
+        if(pthread_create(&ids[started], NULL, appendBenchWorker, &jobs[started]) != 0) {
+            printf("Error: Could only start %d of %d threads\n", started, threads);
+            break;
+        }
+    }
+    for(int i = 0; i < started; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    double elapsed = nowSeconds() - start;
+    unsigned long long batches = log->batches, syncs = log->syncs;
+    closeAppendLog(log);
+    
+    long long total = (long long)started * records;
+    printf("%lld records in %.3f s: %.0f records/s, %llu batches (%.1f records/batch), %llu syncs\n",
+           total, elapsed, elapsed > 0 ? total / elapsed : 0.0, batches,
+           batches > 0 ? (double)total / batches : 0.0, syncs);
+    free(ids);
+    free(jobs);
+    return started == threads ? 0 : 1;
+}
+
+// Parse a durability mode name
+static int parseDurability(const char* name, Durability* durability) {
+    static const char* names[] = { "none", "batch", "record" };
+    for(int i = 0; i < 3; i++) {
+        if(strcmp(name, names[i]) == 0) {
+            *durability = (Durability)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Bulk commands run each file through a small state machine on the engine
+typedef enum {
+    TASK_COPY,
+    TASK_CAT,
+    TASK_APPEND
+} FileTaskKind;
+
+typedef struct FileBatch FileBatch;
+
+// One file of a copy/cat/append command. ops[0] works on the source,
+// ops[1] on the target.
+typedef struct {
+    FileBatch* batch;
+    FileTaskKind kind;
+    const char* source;
+    const char* target;
+    int sourceFd;
+    int targetFd;
+    int waiting;            // operations of the current step in flight
+    int error;              // first errno seen
+    char* buffer;
+    size_t filled;          // bytes of buffer holding data
+    size_t capacity;
+    size_t written;         // bytes of buffer already written
+    off_t offset;
+    long long bytes;
+    int done;
+    int parked;             // cat chunk waiting for earlier files to print
+    AsyncOp ops[2];
+} FileTask;
+
+// State shared by all tasks of a command
+struct FileBatch {
+    AsyncEngine* engine;
+    FileTask* tasks;
+    int count;
+    int started;
+    int printed;            // cat output goes out in argument order;
+                            // only tasks[printed] writes to stdout
+    int failures;
+    long long bytes;
+    const char* text;       // payload of append
+    size_t textLength;
+};
+
+static void startTask(FileTask* task);
+static void taskOpened(AsyncOp* op, long result);
+static void taskRead(AsyncOp* op, long result);
+static void taskWritten(AsyncOp* op, long result);
+static void taskClosed(AsyncOp* op, long result);
+
+// Reset one of the task's operations; the caller fills in the rest
+// and submits it
+static AsyncOp* taskOp(FileTask* task, int slot, AsyncOpType type, int fd, AsyncCallback callback) {
+    AsyncOp* op = &task->ops[slot];
+    
+    memset(op, 0, sizeof(AsyncOp));
+    op->type = type;
+    op->fd = fd;
+    op->callback = callback;
+    op->context = task;
+    return op;
+}
+
+// Record the first failure of a task
+static void taskFail(FileTask* task, int error) {
+    if(task->error == 0) {
+        task->error = error;
+    }
+}
+
+// Write the chunk a cat task holds to stdout
+static void printCatChunk(FileTask* task) {
+    struct iovec iov = { task->buffer, task->filled };
+    
+    if(task->filled > 0 && writevAll(STDOUT_FILENO, &iov, 1) != 0) {
+        taskFail(task, errno);
+    }
+    task->filled = 0;
+}
+
+static void taskReadNext(FileTask* task);
+
+// Move the output turn past finished cat tasks and resume the next one
+// if it has a chunk parked
+static void flushCatOutput(FileBatch* batch) {
+    while(batch->printed < batch->count) {
+        FileTask* task = &batch->tasks[batch->printed];
+        if(task->parked) {
+            task->parked = 0;
+            printCatChunk(task);
+            taskReadNext(task);
+            return;
+        }
+        if(!task->done) {
+            return;
+        }
+        batch->printed++;
+    }
+}
+
+// Account for a finished task and start the next one
+static void finishTask(FileTask* task) {
+    FileBatch* batch = task->batch;
+    
+    task->done = 1;
+    batch->bytes += task->bytes;
+    if(task->error != 0) {
+        batch->failures++;
+        fprintf(stderr, "Error: Could not %s '%s': %s\n",
+                task->kind == TASK_APPEND ? "append to" : task->kind == TASK_COPY ? "copy" : "read",
+                task->kind == TASK_APPEND ? task->target : task->source, strerror(task->error));
+    }
+    if(task->kind != TASK_APPEND) {
+        free(task->buffer);
+        task->buffer = NULL;
+    }
+    if(task->kind == TASK_CAT) {
+        flushCatOutput(batch);
+    }
+    if(batch->started < batch->count) {
+        startTask(&batch->tasks[batch->started++]);
+    }
+}
+
+// Close whatever the task has open; the last close finishes it
+static void taskCloseAll(FileTask* task) {
+    int source = task->sourceFd, target = task->targetFd;
+    
+    task->waiting = (source >= 0) + (target >= 0);
+    if(task->waiting == 0) {
+        finishTask(task);
+        return;
+    }
+    if(source >= 0) {
+        asyncSubmit(task->batch->engine, taskOp(task, 0, ASYNC_CLOSE, source, taskClosed));
+    }
+    if(target >= 0) {
+        asyncSubmit(task->batch->engine, taskOp(task, 1, ASYNC_CLOSE, target, taskClosed));
+    }
+}
+
+// Read the next chunk of the source file
+static void taskReadNext(FileTask* task) {
+    if(task->error != 0) {
+        taskCloseAll(task);
+        return;
+    }
+    AsyncOp* op = taskOp(task, 0, ASYNC_READ, task->sourceFd, taskRead);
+    op->buffer = task->buffer;
+    op->length = ASYNC_CHUNK;
+    op->offset = task->offset;
+    asyncSubmit(task->batch->engine, op);
+}
+
+// Write the unwritten part of the buffer to the target
+static void taskWriteRest(FileTask* task) {
+    AsyncOp* op = taskOp(task, 1, ASYNC_WRITE, task->targetFd, taskWritten);
+    op->buffer = task->buffer + task->written;
+    op->length = task->filled - task->written;
+    // Copies write where the chunk was read from; appends use O_APPEND
+    op->offset = task->kind == TASK_APPEND ? -1 : task->offset - (off_t)op->length;
+    asyncSubmit(task->batch->engine, op);
+}
+
+static void taskOpened(AsyncOp* op, long result) {
+    FileTask* task = op->context;
+    
+    if(result < 0) {
+        taskFail(task, (int)-result);
+    } else if(op == &task->ops[0]) {
+        task->sourceFd = (int)result;
+    } else {
+        task->targetFd = (int)result;
+    }
+    if(--task->waiting > 0) {
+        return;
+    }
+    if(task->error != 0) {
+        taskCloseAll(task);
+    } else if(task->kind == TASK_APPEND) {
+        taskWriteRest(task);
+    } else {
+        taskReadNext(task);
+    }
+}
+
+static void taskRead(AsyncOp* op, long result) {
+    FileTask* task = op->context;
+    
+    if(result <= 0) {
+        if(result < 0) {
+            taskFail(task, (int)-result);
+        }
+        taskCloseAll(task);
+        return;
+    }
+    task->offset += result;
+    task->bytes += result;
+    task->filled = (size_t)result;
+    if(task->kind == TASK_CAT) {
+        // Cat holds one chunk at a time; files later in argument order
+        // wait with it until their turn to print
+        if(&task->batch->tasks[task->batch->printed] != task) {
+            task->parked = 1;
+            return;
+        }
+        printCatChunk(task);
+        taskReadNext(task);
+        return;
+    }
+    task->written = 0;
+    taskWriteRest(task);
+}
+
+static void taskWritten(AsyncOp* op, long result) {
+    FileTask* task = op->context;
+    
+    if(result <= 0) {
+        taskFail(task, result < 0 ? (int)-result : EIO);
+        taskCloseAll(task);
+        return;
+    }
+    task->written += (size_t)result;
+    if(task->written < task->filled) {
+        taskWriteRest(task);
+    } else if(task->kind == TASK_APPEND) {
+        task->bytes = (long long)task->filled;
+        taskCloseAll(task);
+    } else {
+        taskReadNext(task);
+    }
+}
+
+static void taskClosed(AsyncOp* op, long result) {
+    FileTask* task = op->context;
+    
+    if(result < 0) {
+        taskFail(task, (int)-result);
+    }
+    if(op == &task->ops[0]) {
+        task->sourceFd = -1;
+    } else {
+        task->targetFd = -1;
+    }
+    if(--task->waiting == 0) {
+        finishTask(task);
+    }
+}
+
+// Open the files of a task
+static void startTask(FileTask* task) {
+    AsyncEngine* engine = task->batch->engine;
+    AsyncOp* op;
+    
+    task->sourceFd = -1;
+    task->targetFd = -1;
+    if(task->kind == TASK_APPEND) {
+        task->buffer = (char*)task->batch->text;
+        task->filled = task->batch->textLength;
+    } else {
+        task->buffer = malloc(ASYNC_CHUNK);
+        task->capacity = ASYNC_CHUNK;
+        if(task->buffer == NULL) {
+            taskFail(task, ENOMEM);
+            finishTask(task);
+            return;
+        }
+    }
+    
+    task->waiting = task->kind == TASK_COPY ? 2 : 1;
+    if(task->kind != TASK_APPEND) {
+        op = taskOp(task, 0, ASYNC_OPEN, -1, taskOpened);
+        op->path = task->source;
+        op->flags = O_RDONLY;
+        asyncSubmit(engine, op);
+    }
+    if(task->kind != TASK_CAT) {
+        op = taskOp(task, 1, ASYNC_OPEN, -1, taskOpened);
+        op->path = task->target;
+        op->flags = O_WRONLY | O_CREAT | (task->kind == TASK_APPEND ? O_APPEND : O_TRUNC);
+        asyncSubmit(engine, op);
+    }
+}
+
+// Run copy/cat/append over many files at once. paths holds source/target
+// pairs for copy and plain file names otherwise. FILE_OP_THREADS=N in the
+// environment forces the thread-pool backend.
+static int runFileBatch(FileTaskKind kind, char* paths[], int count, const char* text) {
+    static const char* verbs[] = { "Copied", "Read", "Appended to" };
+    const char* threads = getenv("FILE_OP_THREADS");
+    FileBatch batch;
+    double start, elapsed;
+    
+    memset(&batch, 0, sizeof(batch));
+    batch.engine = asyncCreate(ASYNC_DEPTH, threads != NULL ? atoi(threads) : 0);
+    batch.count = count;
+    batch.tasks = calloc((size_t)count + 1, sizeof(FileTask));
+    if(batch.engine == NULL || batch.tasks == NULL) {
+        fprintf(stderr, "Error: Could not start the async engine\n");
+        free(batch.tasks);
+        return 1;
+    }
+    
+    char* payload = NULL;
+    if(kind == TASK_APPEND) {
+        batch.textLength = strlen(text) + 1;
+        payload = malloc(batch.textLength);
+        if(payload == NULL) {
+            asyncDestroy(batch.engine);
+            free(batch.tasks);
+            return 1;
+        }
+        memcpy(payload, text, batch.textLength - 1);
+        payload[batch.textLength - 1] = '\n';
+        batch.text = payload;
+    }
+    for(int i = 0; i < count; i++) {
+        FileTask* task = &batch.tasks[i];
+        task->batch = &batch;
+        task->kind = kind;
+        task->source = kind == TASK_COPY ? paths[2 * i] : paths[i];
+        task->target = kind == TASK_COPY ? paths[2 * i + 1] : paths[i];
+    }
+    
+    start = nowSeconds();
+    while(batch.started < count && batch.started < ASYNC_ACTIVE_FILES) {
+        startTask(&batch.tasks[batch.started++]);
+    }
+    while(asyncPending(batch.engine) > 0) {
+        if(asyncWait(batch.engine) < 0) {
+            fprintf(stderr, "Error: Async engine failed: %s\n", strerror(errno));
+            break;
+        }
+    }
+    elapsed = nowSeconds() - start;
+    
+    // stdout carries the data for cat, so the summary goes to stderr
+    fprintf(stderr, "%s %d files (%d failed), %lld bytes in %.3f s: %.0f files/s, %.1f MB/s [%s]\n",
+            verbs[kind], count, batch.failures, batch.bytes, elapsed,
+            elapsed > 0 ? count / elapsed : 0.0, elapsed > 0 ? batch.bytes / elapsed / 1e6 : 0.0,
+            asyncBackendName(batch.engine));
+    asyncDestroy(batch.engine);
+    free(batch.tasks);
+    free(payload);
+    return batch.failures > 0;
+}
+
+// Operations a batch manifest can request
+typedef enum {
+    BATCH_CREATE,
+    BATCH_WRITE,
+    BATCH_READ,
+    BATCH_APPEND
+} BatchOpType;
+
+// Where write/append take their bytes from
+typedef enum {
+    PAYLOAD_TEXT,   // rest of the manifest line plus a newline
+    PAYLOAD_FILE,   // @PATH: contents of another file
+    PAYLOAD_FILL    // +N: N bytes of filler
+} PayloadKind;
+
+// One manifest line and, after the run, its outcome
+typedef struct {
+    BatchOpType type;
+    PayloadKind payloadKind;
+    char* path;
+    char* payload;
+    long long fillSize;
+    int line;
+    double seconds;
+    long long bytes;
+    int error;
+    int waiting;        // earlier ops on the same files still to finish
+    int next[2];        // later ops waiting for this one, -1 if none
+} BatchOp;
+
+// A batch run: ops in manifest order, handed to whichever worker is free
+// once the earlier ops on their files have finished
+typedef struct {
+    BatchOp* ops;
+    int count;
+    int threads;
+    int* ready;         // ops free to run, in the order they became so
+    int readyHead;
+    int readyTail;
+    int finished;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    const char* fill;   // BATCH_FILL_CHUNK bytes of filler
+} BatchRun;
+
+static const char* batchOpNames[] = { "create", "write", "read", "append" };
+
+// FNV-1a hash of a path
+static unsigned hashPath(const char* path) {
+    unsigned hash = 2166136261u;
+    while(*path) {
+        hash = (hash ^ (unsigned char)*path++) * 16777619u;
+    }
+    return hash;
+}
+
+// Parse "OP PATH [PAYLOAD]" into op; returns -1 for a malformed line
+static int parseBatchLine(char* line, int number, BatchOp* op) {
+    char* name = strtok(line, " \t");
+    char* path = strtok(NULL, " \t");
+    char* payload = strtok(NULL, "");
+    
+    memset(op, 0, sizeof(BatchOp));
+    op->line = number;
+    if(name == NULL || path == NULL) {
+        return -1;
+    }
+    op->type = (BatchOpType)-1;
+    for(int i = 0; i < 4; i++) {
+        if(strcmp(name, batchOpNames[i]) == 0) {
+            op->type = (BatchOpType)i;
+        }
+    }
+    if((int)op->type < 0) {
+        return -1;
+    }
+    
+    if(op->type == BATCH_WRITE || op->type == BATCH_APPEND) {
+        payload = payload != NULL ? payload + strspn(payload, " \t") : "";
+        if(payload[0] == '@') {
+            op->payloadKind = PAYLOAD_FILE;
+            payload++;
+        } else if(payload[0] == '+') {
+            char* end;
+            op->payloadKind = PAYLOAD_FILL;
+            errno = 0;
+            op->fillSize = strtoll(payload + 1, &end, 10);
+            if(end == payload + 1 || *end != '\0' || errno != 0 || op->fillSize < 0) {
+                return -1;
+            }
+        } else {
+            op->payloadKind = PAYLOAD_TEXT;
+        }
+        op->payload = strdup(payload);
+        if(op->payload == NULL) {
+            return -1;
+        }
+    }
+    op->path = strdup(path);
+    return op->path != NULL ? 0 : -1;
+}
+
+// Read a manifest: one operation per line, blank lines and lines starting
+// with '#' ignored. Returns the op count, or -1 after printing the error.
+static int loadManifest(const char* filename, BatchOp** ops) {
+    FILE* manifest = strcmp(filename, "-") == 0 ? stdin : fopen(filename, "r");
+    char* line = NULL;
+    size_t size = 0;
+    ssize_t length;
+    int count = 0, capacity = 0, number = 0, failed = 0;
+    
+    *ops = NULL;
+    if(manifest == NULL) {
+        printf("Error: Could not open manifest '%s'\n", filename);
+        return -1;
+    }
+    while((length = getline(&line, &size, manifest)) >= 0) {
+        number++;
+        line[strcspn(line, "\r\n")] = 0;
+        if(line[strspn(line, " \t")] == 0 || line[strspn(line, " \t")] == '#') {
+            continue;
+        }
+        if(count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            BatchOp* grown = realloc(*ops, sizeof(BatchOp) * capacity);
+            if(grown == NULL) {
+                printf("Error: Out of memory\n");
+                failed = 1;
+                break;
+            }
+            *ops = grown;
+        }
+        if(parseBatchLine(line, number, &(*ops)[count]) != 0) {
+            printf("Error: Manifest line %d is not 'create|write|read|append PATH [PAYLOAD]'\n", number);
+            free((*ops)[count].path);
+            free((*ops)[count].payload);
+            failed = 1;
+            break;
+        }
+        count++;
+    }
+    free(line);
+    if(manifest != stdin) {
+        fclose(manifest);
+    }
+    if(failed) {
+        for(int i = 0; i < count; i++) {
+            free((*ops)[i].path);
+            free((*ops)[i].payload);
+        }
+        free(*ops);
+        *ops = NULL;
+        return -1;
+    }
+    return count;
+}
+
+// Write (or append) the payload of an op through a buffered writer
+static int writePayload(BatchOp* op, const char* fill) {
+    FileWriter* writer;
+    MappedFile source = { NULL, 0 };
+    int result = 0;
+    
+    if(op->payloadKind == PAYLOAD_FILE && mapFile(op->payload, &source) != 0) {
+        return -1;
+    }
+    off_t expected = op->payloadKind == PAYLOAD_FILE ? (off_t)source.length
+                   : op->payloadKind == PAYLOAD_FILL ? (off_t)op->fillSize : (off_t)strlen(op->payload) + 1;
+    // Size the buffer to the payload: batches are mostly small files
+    size_t bufferSize = expected < DIRECT_ALIGNMENT ? DIRECT_ALIGNMENT
+                      : expected > WRITE_BUFFER_SIZE ? WRITE_BUFFER_SIZE : (size_t)expected;
+    int flags = (op->type == BATCH_APPEND ? WRITER_APPEND : 0) | (op->payloadKind != PAYLOAD_TEXT ? WRITER_PREALLOCATE : 0);
+    writer = openWriter(op->path, flags, bufferSize, expected);
+    if(writer == NULL) {
+        unmapFile(&source);
+        return -1;
+    }
+    
+    if(op->payloadKind == PAYLOAD_FILE) {
+        result = writerWrite(writer, source.data, source.length);
+        op->bytes = (long long)source.length;
+    } else if(op->payloadKind == PAYLOAD_FILL) {
+        for(long long left = op->fillSize; left > 0 && result == 0; left -= BATCH_FILL_CHUNK) {
+            result = writerWrite(writer, fill, left < BATCH_FILL_CHUNK ? (size_t)left : BATCH_FILL_CHUNK);
+        }
+        op->bytes = op->fillSize;
+    } else {
+        struct iovec text[2] = { { op->payload, strlen(op->payload) }, { "\n", 1 } };
+        result = writerWritev(writer, text, 2);
+        op->bytes = (long long)(text[0].iov_len + 1);
+    }
+    if(closeWriter(writer) != 0) {
+        result = -1;
+    }
+    unmapFile(&source);
+    return result;
+}
+
+// Carry out one manifest operation
+static int runBatchOp(BatchOp* op, const char* fill) {
+    int fd, result = 0;
+    
+    switch(op->type) {
+        case BATCH_CREATE:
+            fd = open(op->path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            return fd >= 0 ? close(fd) : -1;
+        case BATCH_WRITE:
+            return writePayload(op, fill);
+        case BATCH_APPEND:
+            result = writePayload(op, fill);
+            return result == 0 ? updateLineIndex(op->path, 0) : result;
+        case BATCH_READ: {
+            CopyMethod method;
+            int sink = open("/dev/null", O_WRONLY);
+            fd = open(op->path, O_RDONLY);
+            if(fd >= 0 && sink >= 0) {
+                op->bytes = copyFile(fd, sink, &method);
+                result = op->bytes < 0 ? -1 : 0;
+            } else {
+                result = -1;
+            }
+            if(fd >= 0) {
+                close(fd);
+            }
+            if(sink >= 0) {
+                close(sink);
+            }
+            return result;
+        }
+    }
+    return -1;
+}
+
+// Chain the ops of each file in manifest order: an op waits for the
+// previous op that touched its path or its @FILE source. Returns -1 when
+// out of memory.
+static int linkBatchOps(BatchRun* run) {
+    size_t slots = 16;
+    while(slots < (size_t)run->count * 4) {
+        slots *= 2;
+    }
+    const char** files = calloc(slots, sizeof(char*));
+    int* last = malloc(sizeof(int) * slots);
+    if(files == NULL || last == NULL) {
+        free(files);
+        free(last);
+        return -1;
+    }
+    for(size_t slot = 0; slot < slots; slot++) {
+        last[slot] = -1;
+    }
+    
+    for(int i = 0; i < run->count; i++) {
+        BatchOp* op = &run->ops[i];
+        const char* touched[2] = { op->path, NULL };
+        int linked = -1;
+        if(op->payloadKind == PAYLOAD_FILE && strcmp(op->payload, op->path) != 0) {
+            touched[1] = op->payload;
+        }
+        op->next[0] = op->next[1] = -1;
+        for(int f = 0; f < 2 && touched[f] != NULL; f++) {
+            size_t slot = hashPath(touched[f]) & (slots - 1);
+            while(files[slot] != NULL && strcmp(files[slot], touched[f]) != 0) {
+                slot = (slot + 1) & (slots - 1);
+            }
+            files[slot] = touched[f];
+            int previous = last[slot];
+            last[slot] = i;
+            if(previous < 0 || previous == linked) {
+                continue;
+            }
+            BatchOp* before = &run->ops[previous];
+            before->next[before->next[0] < 0 ? 0 : 1] = i;
+            op->waiting++;
+            linked = previous;
+        }
+        if(op->waiting == 0) {
+            run->ready[run->readyTail++] = i;
+        }
+    }
+    free(files);
+    free(last);
+    return 0;
+}
+
+// Worker: take ready ops until every op has finished, releasing the ops
+// that waited for each one
+static void* batchWorker(void* arg) {
+    BatchRun* run = arg;
+    
+    pthread_mutex_lock(&run->lock);
+    for(;;) {
+        while(run->readyHead == run->readyTail && run->finished < run->count) {
+            pthread_cond_wait(&run->wake, &run->lock);
+        }
+        if(run->readyHead == run->readyTail) {
+            break;
+        }
+        BatchOp* op = &run->ops[run->ready[run->readyHead++]];
+        pthread_mutex_unlock(&run->lock);
+        
+        double start = nowSeconds();
+        errno = 0;
+        if(runBatchOp(op, run->fill) != 0) {
+            op->error = errno != 0 ? errno : EIO;
+        }
+        op->seconds = nowSeconds() - start;
+        
+        pthread_mutex_lock(&run->lock);
+        int released = 0;
+        run->finished++;
+        for(int k = 0; k < 2; k++) {
+            if(op->next[k] >= 0 && --run->ops[op->next[k]].waiting == 0) {
+                run->ready[run->readyTail++] = op->next[k];
+                released++;
+            }
+        }
+        if(released > 0 || run->finished == run->count) {
+            pthread_cond_broadcast(&run->wake);
+        }
+    }
+    pthread_mutex_unlock(&run->lock);
+    return NULL;
+}
+
+// Compare latencies for qsort
+static int compareSeconds(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Print count, bytes and latency percentiles of each op type
+static void reportBatch(BatchRun* run, double elapsed, int quiet) {
+    double* latencies = malloc(sizeof(double) * (run->count + 1));
+    long long totalBytes = 0;
+    int failures = 0;
+    
+    for(int i = 0; i < run->count; i++) {
+        BatchOp* op = &run->ops[i];
+        if(!quiet || op->error != 0) {
+            printf("%-6s %-40s %10lld bytes %9.3f ms %s\n", batchOpNames[op->type], op->path, op->bytes,
+                   op->seconds * 1e3, op->error != 0 ? strerror(op->error) : "ok");
+        }
+        totalBytes += op->bytes;
+        failures += op->error != 0;
+    }
+    
+    printf("\n%-6s %8s %12s %10s %10s %10s\n", "op", "count", "bytes", "p50 ms", "p99 ms", "max ms");
+    for(int type = 0; type < 4 && latencies != NULL; type++) {
+        int count = 0;
+        long long bytes = 0;
+        for(int i = 0; i < run->count; i++) {
+            if(run->ops[i].type == (BatchOpType)type) {
+                latencies[count++] = run->ops[i].seconds;
+                bytes += run->ops[i].bytes;
+            }
+        }
+        if(count == 0) {
+            continue;
+        }
+        qsort(latencies, count, sizeof(double), compareSeconds);
+        printf("%-6s %8d %12lld %10.3f %10.3f %10.3f\n", batchOpNames[type], count, bytes,
+               latencies[count / 2] * 1e3, latencies[(int)(count * 0.99)] * 1e3, latencies[count - 1] * 1e3);
+    }
+    printf("%d operations (%d failed) on %d threads in %.3f s: %.0f ops/s, %.1f MB/s\n",
+           run->count, failures, run->threads, elapsed, elapsed > 0 ? run->count / elapsed : 0.0,
+           elapsed > 0 ? totalBytes / elapsed / 1e6 : 0.0);
+    free(latencies);
+}
+
+// Run a manifest across a pool of workers. Ops on the same file keep
+// their manifest order, counting both the target path and an @FILE
+// source; everything else runs on whichever worker is free. Paths are
+// compared as written, so "a" and "./a" count as different files.
+static int runBatch(const char* manifest, int threads, int quiet) {
+    BatchRun run;
+    char* fill;
+    pthread_t* ids;
+    double start, elapsed;
+    int started = 0, failed = 0;
+    
+    memset(&run, 0, sizeof(run));
+    run.count = loadManifest(manifest, &run.ops);
+    if(run.count < 0) {
+        return 1;
+    }
+    run.threads = threads > 0 ? threads : BATCH_THREADS;
+    if(run.threads > run.count && run.count > 0) {
+        run.threads = run.count;
+    }
+    
+    fill = malloc(BATCH_FILL_CHUNK);
+    run.ready = malloc(sizeof(int) * (run.count + 1));
+    ids = malloc(sizeof(pthread_t) * run.threads);
+    if(fill == NULL || run.ready == NULL || ids == NULL || linkBatchOps(&run) != 0) {
+        printf("Error: Out of memory\n");
+        failed = 1;
+    } else {
+        for(int i = 0; i < BATCH_FILL_CHUNK; i++) {
+            fill[i] = (char)('a' + i % 26);
+        }
+        run.fill = fill;
+        pthread_mutex_init(&run.lock, NULL);
+        pthread_cond_init(&run.wake, NULL);
+        
+        start = nowSeconds();
+        for(; started < run.threads; started++) {
+            if(pthread_create(&ids[started], NULL, batchWorker, &run) != 0) {
+                printf("Error: Could only start %d of %d threads\n", started, run.threads);
+                break;
+            }
+        }
+        // The shared queue lets fewer workers finish the run; with none,
+        // this thread does it alone
+        if(started == 0) {
+            batchWorker(&run);
+        }
+        for(int w = 0; w < started; w++) {
+            pthread_join(ids[w], NULL);
+        }
+        elapsed = nowSeconds() - start;
+        run.threads = started > 0 ? started : 1;
+        reportBatch(&run, elapsed, quiet);
+        pthread_mutex_destroy(&run.lock);
+        pthread_cond_destroy(&run.wake);
+    }
+    
+    for(int i = 0; i < run.count; i++) {
+        failed |= run.ops[i].error != 0;
+        free(run.ops[i].path);
+        free(run.ops[i].payload);
+    }
+    free(run.ops);
+    free(run.ready);
+    free(ids);
+    free(fill);
+    return failed;
+}
+
+// Non-interactive entry point: file_op <command> [arguments]
+int runCommand(int argc, char* argv[]) {
+    Durability durability = DURABILITY_BATCH;
+    
+    if(strcmp(argv[1], "append-bench") == 0 && argc >= 5) {
+        if(argc >= 6 && parseDurability(argv[5], &durability) != 0) {
+            printf("Error: Unknown durability mode '%s'\n", argv[5]);
+            return 1;
+        }
+        return appendBenchmark(argv[2], atoi(argv[3]), atoi(argv[4]), durability);
+    }
+    if(strcmp(argv[1], "batch") == 0 && argc >= 3) {
+        int threads = 0, quiet = 0, arg = 2;
+        for(; arg < argc - 1; arg++) {
+            if(strcmp(argv[arg], "-q") == 0) {
+                quiet = 1;
+            } else if(strcmp(argv[arg], "-j") == 0 && arg + 1 < argc - 1) {
+                threads = atoi(argv[++arg]);
+            } else {
+                break;
+            }
+        }
+        if(arg == argc - 1) {
+            return runBatch(argv[arg], threads, quiet);
+        }
+    }
+    if(strcmp(argv[1], "index") == 0 && argc == 3) {
+        if(updateLineIndex(argv[2], 1) != 0) {
+            printf("Error: Could not index file '%s': %s\n", argv[2], strerror(errno));
+            return 1;
+        }
+        return 0;
+    }
+    if(strcmp(argv[1], "lines") == 0 && argc == 5) {
+        char* lines;
+        ssize_t length = readLines(argv[2], atoll(argv[3]) - 1, atoll(argv[4]), &lines);
+        if(length < 0) {
+            printf("Error: Could not read lines from file '%s'\n", argv[2]);
+            return 1;
+        }
+        fwrite(lines, 1, (size_t)length, stdout);
+        free(lines);
+        return 0;
+    }
+    if(strcmp(argv[1], "follow") == 0 && (argc == 3 || (argc == 4 && strcmp(argv[2], "-a") == 0))) {
+        return followFile(argv[argc - 1], argc == 4 ? 0 : -1, 0) == 0 ? 0 : 1;
+    }
+    if(strcmp(argv[1], "copy") == 0 && argc >= 4 && argc % 2 == 0) {
+        return runFileBatch(TASK_COPY, argv + 2, (argc - 2) / 2, NULL);
+    }
+    if(strcmp(argv[1], "cat") == 0 && argc >= 3) {
+        return runFileBatch(TASK_CAT, argv + 2, argc - 2, NULL);
+    }
+    if(strcmp(argv[1], "append") == 0 && argc >= 4) {
+        return runFileBatch(TASK_APPEND, argv + 3, argc - 3, argv[2]);
+    }
+    
+    printf("Usage: %s                      interactive menu\n", argv[0]);
+    printf("       %s append-bench FILE THREADS RECORDS [none|batch|record]\n", argv[0]);
+    printf("       %s batch [-j THREADS] [-q] MANIFEST|-\n", argv[0]);
+    printf("       %s index FILE\n", argv[0]);
+    printf("       %s lines FILE FIRST COUNT\n", argv[0]);
+    printf("       %s follow [-a] FILE\n", argv[0]);
+    printf("       %s copy SOURCE TARGET [SOURCE TARGET]...\n", argv[0]);
+    printf("       %s cat FILE...\n", argv[0]);
+    printf("       %s append TEXT FILE...\n", argv[0]);
+    return 1;
 }
\ No newline at end of file
@@ -1,11 +1,29 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #define MAX_TOKEN_LENGTH 100
 #define MAX_KEYWORDS 32
 
+// Token cache: one file per distinct input, named by the 64-bit hash of the
+// input's bytes and holding its tokens in the mmap-able TokenList layout
+#define TOKEN_CACHE_DIR "lexical_analyser"   // under $XDG_CACHE_HOME or ~/.cache;
+                                             // overridden by LEX_CACHE_DIR
+#define TOKEN_CACHE_MAX_BYTES (64L << 20)    // overridden by LEX_CACHE_MAX_BYTES
+#define TOKEN_CACHE_MAGIC "LXC1"
+#define TOKEN_CACHE_VERSION 1                // bump when the lexer output changes
+
 // Token types
 typedef enum {
     TOKEN_KEYWORD,
@@ -25,6 +43,39 @@ typedef struct {
     int line_number;
 } Token;
 
+// Compact form of a token: its text lives in the list's string pool
+typedef struct {
+    int32_t type;
+    int32_t line_number;
+    uint32_t value_offset;
+    uint32_t value_length;
+} PackedToken;
+
+// Tokens of one file, either lexed into heap arrays or mapped from the cache
+typedef struct {
+    PackedToken* tokens;
+    char* strings;          // NUL-terminated token values
+    int count;
+    int capacity;
+    size_t strings_size;
+    size_t strings_capacity;
+    int line_count;
+    void* mapping;          // cache file mapping backing the arrays, if any
+    size_t mapping_size;
+} TokenList;
+
+// Header of a token cache file; PackedToken records and then the string
+// pool follow it
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint64_t hash;
+    uint64_t source_size;
+    int32_t token_count;
+    int32_t line_count;
+    uint64_t strings_size;
+} TokenCacheHeader;
+
 // C Keywords list
 const char* keywords[MAX_KEYWORDS] = {
     "auto", "break", "case", "char", "const", "continue", "default", "do",
@@ -59,6 +110,12 @@ int is_delimiter(char ch);
 Token get_next_token();
 void print_token(Token token);
 void analyze_file(const char* filename);
+uint64_t hash_bytes(const void* data, size_t length, uint64_t seed);
+int lex_tokens(FILE* file, TokenList* list);
+int load_cached_tokens(uint64_t hash, size_t source_size, TokenList* list);
+void store_cached_tokens(uint64_t hash, size_t source_size, const TokenList* list);
+void free_tokens(TokenList* list);
+Token token_at(const TokenList* list, int index);
 
 // Get next character from file
 void get_next_char() {
@@ -299,10 +356,442 @@ void print_token(Token token) {
     printf("Line %d: %-12s -> '%s'\n", token.line_number, type_names[token.type], token.value);
 }
 
+// 64-bit hash of a byte buffer (XXH64)
+#define HASH_PRIME1 0x9E3779B185EBCA87ULL
+#define HASH_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define HASH_PRIME3 0x165667B19E3779F9ULL
+#define HASH_PRIME4 0x85EBCA77C2B2AE63ULL
+#define HASH_PRIME5 0x27D4EB2F165667C5ULL
+
+static uint64_t rotate_left(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t hash_round(uint64_t acc, uint64_t input) {
+    acc += input * HASH_PRIME2;
+    return rotate_left(acc, 31) * HASH_PRIME1;
+}
+
+static uint64_t hash_merge(uint64_t acc, uint64_t value) {
+    acc ^= hash_round(0, value);
+    return acc * HASH_PRIME1 + HASH_PRIME4;
+}
+
+static uint64_t read_u64(const unsigned char* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t read_u32(const unsigned char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint64_t hash_bytes(const void* data, size_t length, uint64_t seed) {
+    const unsigned char* p = data;
+    const unsigned char* end = p + length;
+    uint64_t hash;
+    
+    if (length >= 32) {
+        // Four independent lanes keep the multipliers busy
+        uint64_t v1 = seed + HASH_PRIME1 + HASH_PRIME2;
+        uint64_t v2 = seed + HASH_PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - HASH_PRIME1;
+        do {
+            v1 = hash_round(v1, read_u64(p));
+            v2 = hash_round(v2, read_u64(p + 8));
+            v3 = hash_round(v3, read_u64(p + 16));
+            v4 = hash_round(v4, read_u64(p + 24));
+            p += 32;
+        } while (p + 32 <= end);
+        hash = rotate_left(v1, 1) + rotate_left(v2, 7) + rotate_left(v3, 12) + rotate_left(v4, 18);
+        hash = hash_merge(hash, v1);
+        hash = hash_merge(hash, v2);
+        hash = hash_merge(hash, v3);
+        hash = hash_merge(hash, v4);
+    } else {
+        hash = seed + HASH_PRIME5;
+    }
+    hash += (uint64_t)length;
+    
+    for (; p + 8 <= end; p += 8) {
+        hash ^= hash_round(0, read_u64(p));
+        hash = rotate_left(hash, 27) * HASH_PRIME1 + HASH_PRIME4;
+    }
+    if (p + 4 <= end) {
+        hash ^= (uint64_t)read_u32(p) * HASH_PRIME1;
+        hash = rotate_left(hash, 23) * HASH_PRIME2 + HASH_PRIME3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        hash ^= (*p) * HASH_PRIME5;
+        hash = rotate_left(hash, 11) * HASH_PRIME1;
+    }
+    
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// Add a token to the end of a list
+static int push_token(TokenList* list, const Token* token) {
+    size_t length = strlen(token->value);
+    
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 256;
+        PackedToken* grown = realloc(list->tokens, sizeof(PackedToken) * capacity);
+        if (!grown) {
+            return -1;
+        }
+        list->tokens = grown;
+        list->capacity = capacity;
+    }
+    if (list->strings_size + length + 1 > list->strings_capacity) {
+        size_t capacity = list->strings_capacity ? list->strings_capacity * 2 : 4096;
+        char* grown = realloc(list->strings, capacity);
+        if (!grown) {
+            return -1;
+        }
+        list->strings = grown;
+        list->strings_capacity = capacity;
+    }
+    
+    PackedToken* packed = &list->tokens[list->count++];
+    packed->type = token->type;
+    packed->line_number = token->line_number;
+    packed->value_offset = (uint32_t)list->strings_size;
+    packed->value_length = (uint32_t)length;
+    memcpy(list->strings + list->strings_size, token->value, length + 1);
+    list->strings_size += length + 1;
+    return 0;
+}
+
+// Lex a whole file into list; returns -1 if memory runs out
+int lex_tokens(FILE* file, TokenList* list) {
+    memset(list, 0, sizeof(*list));
+    input_file = file;
+    current_line = 1;
+    eof_reached = 0;
+    get_next_char();
+    
+    for (;;) {
+        Token token = get_next_token();
+        if (token.type == TOKEN_EOF) {
+            break;
+        }
+        if (push_token(list, &token) != 0) {
+            free_tokens(list);
+            return -1;
+        }
+    }
+    list->line_count = current_line - 1;
+    return 0;
+}
+
+// Unpack one token of a list
+Token token_at(const TokenList* list, int index) {
+    const PackedToken* packed = &list->tokens[index];
+    Token token;
+    
+    token.type = (TokenType)packed->type;
+    token.line_number = packed->line_number;
+    memcpy(token.value, list->strings + packed->value_offset, packed->value_length + 1);
+    return token;
+}
+
+// Release a token list, whether lexed or mapped
+void free_tokens(TokenList* list) {
+    if (list->mapping) {
+        munmap(list->mapping, list->mapping_size);
+    } else {
+        free(list->tokens);
+        free(list->strings);
+    }
+    memset(list, 0, sizeof(*list));
+}
+
+// Cache directory in use; NULL when LEX_CACHE_DIR is set to "" or no
+// user cache directory can be found
+static const char* cache_dir() {
+    static char default_dir[4096];
+    const char* dir = getenv("LEX_CACHE_DIR");
+    if (dir) {
+        return dir[0] ? dir : NULL;
+    }
+    if (!default_dir[0]) {
+        const char* base = getenv("XDG_CACHE_HOME");
+        if (base && base[0] == '/') {
+            snprintf(default_dir, sizeof(default_dir), "%s/%s", base, TOKEN_CACHE_DIR);
+        } else if ((base = getenv("HOME")) != NULL && base[0] == '/') {
+            snprintf(default_dir, sizeof(default_dir), "%s/.cache/%s", base, TOKEN_CACHE_DIR);
+        } else {
+            return NULL;
+        }
+    }
+    return default_dir;
+}
+
+// Create a directory and any missing parents
+static int make_dirs(const char* dir) {
+    char path[4096];
+    
+    if (strlen(dir) >= sizeof(path)) {
+        return -1;
+    }
+    strcpy(path, dir);
+    for (char* p = path + 1; *p; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+                return -1;
+            }
+            *p = '/';
+        }
+    }
+    return mkdir(path, 0755) == 0 || errno == EEXIST ? 0 : -1;
+}
+
+// Path of the cache file for a hash
+static void cache_path(uint64_t hash, char* path, size_t size) {
+    snprintf(path, size, "%s/%016llx.tok", cache_dir(), (unsigned long long)hash);
+}
+
+// Map the cached tokens of an input. Returns 0 on a hit; the hit also
+// refreshes the file's mtime, which is what eviction orders by.
+int load_cached_tokens(uint64_t hash, size_t source_size, TokenList* list) {
+    char path[4096];
+    struct stat info;
+    
+    if (!cache_dir()) {
+        return -1;
+    }
+    cache_path(hash, path, sizeof(path));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(TokenCacheHeader)) {
+        close(fd);
+        return -1;
+    }
+    void* map = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    
+    // Sizes come from disk: check each against what is left of the file
+    // by subtraction, so no sum of them can wrap
+    const TokenCacheHeader* header = map;
+    size_t available = (size_t)info.st_size - sizeof(TokenCacheHeader);
+    size_t records = 0;
+    int valid = memcmp(header->magic, TOKEN_CACHE_MAGIC, 4) == 0 && header->version == TOKEN_CACHE_VERSION &&
+                header->hash == hash && header->source_size == source_size && header->token_count >= 0 &&
+                (size_t)header->token_count <= available / sizeof(PackedToken);
+    if (valid) {
+        records = sizeof(PackedToken) * (size_t)header->token_count;
+        available -= records;
+        valid = header->strings_size == available &&
+                (header->strings_size == 0 || ((char*)map)[info.st_size - 1] == '\0');
+    }
+    if (!valid) {
+        munmap(map, info.st_size);
+        return -1;
+    }
+    memset(list, 0, sizeof(*list));
+    list->tokens = (PackedToken*)((char*)map + sizeof(TokenCacheHeader));
+    list->strings = (char*)map + sizeof(TokenCacheHeader) + records;
+    list->count = header->token_count;
+    list->capacity = header->token_count;
+    list->strings_size = header->strings_size;
+    list->line_count = header->line_count;
+    list->mapping = map;
+    list->mapping_size = info.st_size;
+    
+    // Offsets come from disk; a bad one would read past the pool
+    for (int i = 0; i < list->count; i++) {
+        const PackedToken* packed = &list->tokens[i];
+        if ((uint64_t)packed->value_offset + packed->value_length >= list->strings_size ||
+            packed->value_length >= MAX_TOKEN_LENGTH || packed->type < 0 || packed->type >= TOKEN_EOF ||
+            list->strings[packed->value_offset + packed->value_length] != '\0') {
+            free_tokens(list);
+            return -1;
+        }
+    }
+    utimensat(AT_FDCWD, path, NULL, 0);
+    return 0;
+}
+
+// One cache file seen while evicting
+typedef struct {
+    char name[32];
+    off_t size;
+    time_t mtime;
+} CacheEntry;
+
+static int compare_mtime(const void* a, const void* b) {
+    const CacheEntry* x = a;
+    const CacheEntry* y = b;
+    return (x->mtime > y->mtime) - (x->mtime < y->mtime);
+}
+
+// Delete least recently used cache files until the cache fits its budget
+static void evict_cache() {
+    const char* dir = cache_dir();
+    const char* limit_env = getenv("LEX_CACHE_MAX_BYTES");
+    long long limit = limit_env ? atoll(limit_env) : TOKEN_CACHE_MAX_BYTES;
+    CacheEntry* entries = NULL;
+    int count = 0, capacity = 0;
+    long long total = 0;
+    char path[4096];
+    struct stat info;
+    struct dirent* entry;
+    
+    DIR* handle = dir ? opendir(dir) : NULL;
+    if (!handle) {
+        return;
+    }
+    while ((entry = readdir(handle)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        if (length < 5 || length >= sizeof(entries[0].name) || strcmp(entry->d_name + length - 4, ".tok") != 0) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        if (stat(path, &info) != 0) {
+            continue;
+        }
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            CacheEntry* grown = realloc(entries, sizeof(CacheEntry) * capacity);
+            if (!grown) {
+                break;
+            }
+            entries = grown;
+        }
+        strcpy(entries[count].name, entry->d_name);
+        entries[count].size = info.st_size;
+        entries[count].mtime = info.st_mtime;
+        total += info.st_size;
+        count++;
+    }
+    closedir(handle);
+    
+    if (total > limit) {
+        qsort(entries, count, sizeof(CacheEntry), compare_mtime);
+        for (int i = 0; i < count && total > limit; i++) {
+            snprintf(path, sizeof(path), "%s/%s", dir, entries[i].name);
+            if (unlink(path) == 0) {
+                total -= entries[i].size;
+            }
+        }
+    }
+    free(entries);
+}
+
+// Save lexed tokens under the input's hash. The file is written under a
+// temporary name and renamed, so readers never see a partial entry.
+void store_cached_tokens(uint64_t hash, size_t source_size, const TokenList* list) {
+    const char* dir = cache_dir();
+    char path[4096], temp[4200];
+    TokenCacheHeader header;
+    
+    if (!dir) {
+        return;
+    }
+    if (make_dirs(dir) != 0) {
+        return;
+    }
+    cache_path(hash, path, sizeof(path));
+    snprintf(temp, sizeof(temp), "%s.%d.tmp", path, (int)getpid());
+    
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TOKEN_CACHE_MAGIC, 4);
+    header.version = TOKEN_CACHE_VERSION;
+    header.hash = hash;
+    header.source_size = source_size;
+    header.token_count = list->count;
+    header.line_count = list->line_count;
+    header.strings_size = list->strings_size;
+    
+    FILE* out = fopen(temp, "wb");
+    if (!out) {
+        return;
+    }
+    int ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+             (list->count == 0 ||
+              (fwrite(list->tokens, sizeof(PackedToken), list->count, out) == (size_t)list->count &&
+               fwrite(list->strings, 1, list->strings_size, out) == list->strings_size));
+    if (fclose(out) != 0 || !ok || rename(temp, path) != 0) {
+        unlink(temp);
+        return;
+    }
+    
+    // Trim the cache once per run rather than rescanning it on every miss
+    static int eviction_registered = 0;
+    if (!eviction_registered) {
+        eviction_registered = 1;
+        atexit(evict_cache);
+    }
+}
+
+// Get the tokens of a file, from the cache when its contents were seen
+// before. Returns -1 if the file cannot be read.
+static int tokens_for_file(const char* filename, TokenList* list) {
+    struct stat info;
+    void* data = NULL;
+    FILE* file;
+    
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    size_t size = info.st_size;
+    if (size > 0) {
+        data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+    }
+    close(fd);
+    
+    uint64_t hash = hash_bytes(data, size, TOKEN_CACHE_VERSION);
+    if (load_cached_tokens(hash, size, list) == 0) {
+        if (data) {
+            munmap(data, size);
+        }
+        return 0;
+    }
+    
+    // Lex straight from the mapping so the file is read only once
+    file = data ? fmemopen(data, size, "r") : fopen(filename, "r");
+    int result = file ? lex_tokens(file, list) : -1;
+    if (file) {
+        fclose(file);
+    }
+    if (data) {
+        munmap(data, size);
+    }
+    if (result == 0) {
+        store_cached_tokens(hash, size, list);
+    }
+    return result;
+}
+
 // Analyze input file
 void analyze_file(const char* filename) {
-    input_file = fopen(filename, "r");
-    if (!input_file) {
+    TokenList list;
+    
+    if (tokens_for_file(filename, &list) != 0) {
         printf("Error: Cannot open file '%s'\n", filename);
         return;
     }
@@ -312,22 +801,14 @@ void analyze_file(const char* filename) {
     printf("Line:  Token Type    -> Value\n");
     printf("===============================================\n");
     
-    current_line = 1;
-    eof_reached = 0;
-    get_next_char();
-    
-    Token token;
-    do {
-        token = get_next_token();
-        if (token.type != TOKEN_EOF) {
-            print_token(token);
-        }
-    } while (token.type != TOKEN_EOF);
+    for (int i = 0; i < list.count; i++) {
+        print_token(token_at(&list, i));
+    }
     
     printf("===============================================\n");
-    printf("Analysis complete. Total lines processed: %d\n\n", current_line - 1);
+    printf("Analysis complete. Total lines processed: %d\n\n", list.line_count);
     
-    fclose(input_file);
+    free_tokens(&list);
 }
 
 // Create sample input file
@@ -362,7 +843,15 @@ void create_sample_file() {
     printf("Sample input file 'sample_input.c' created successfully!\n");
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Files named on the command line are analyzed without the demo
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            analyze_file(argv[i]);
+        }
+        return 0;
+    }
+    
     printf("=== LEXICAL ANALYZER FOR C LANGUAGE ===\n");
     printf("This program demonstrates lexical analysis in compiler design\n");
     
@@ -1,6 +1,87 @@
+#define _POSIX_C_SOURCE 199309L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+// Optional operation-level instrumentation. Build with -DLL_INSTRUMENT to
+// count calls, nodes traversed, allocations and per-call latency for every
+// list operation; without it the hooks below expand to nothing.
+#ifdef LL_INSTRUMENT
+// Operations that are measured
+typedef enum {
+    OP_CREATE_LIST,
+    OP_INSERT_BEGINNING,
+    OP_INSERT_END,
+    OP_INSERT_POSITION,
+    OP_DELETE_BEGINNING,
+    OP_DELETE_END,
+    OP_DELETE_POSITION,
+    OP_DELETE_VALUE,
+    OP_TRAVERSE,
+    OP_TRAVERSE_REVERSE,
+    OP_SEARCH,
+    OP_CLEAR,
+    OP_DESTROY,
+    OP_LRU_GET,
+    OP_LRU_PUT,
+    OP_LRU_TOUCH,
+    OP_LRU_EVICT,
+    OP_COUNT
+} ListOp;
+
+// Log-bucketed latency histogram (HDR style): values below 2^HIST_SUB_BITS
+// get exact buckets, above that every power of two is split into
+// 2^HIST_SUB_BITS linear sub-buckets, so relative error stays under 1/16.
+#define HIST_SUB_BITS 4
+#define HIST_SUB_COUNT (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS (64 * HIST_SUB_COUNT)
+
+// Per-operation counters
+typedef struct {
+    uint64_t calls;
+    uint64_t nodesTraversed;
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t totalNs;
+    uint64_t minNs;
+    uint64_t maxNs;
+    uint64_t hist[HIST_BUCKETS];
+} OpStats;
+
+// Active measurement; ends automatically when it goes out of scope
+typedef struct {
+    ListOp op;
+    ListOp outer;
+    uint64_t startNs;
+} OpScope;
+
+static const char* opNames[OP_COUNT] = {
+    "createList", "insertAtBeginning", "insertAtEnd", "insertAtPosition",
+    "deleteAtBeginning", "deleteAtEnd", "deleteAtPosition", "deleteByValue",
+    "traverseList", "traverseReverse", "searchElement", "clearList", "destroyList",
+    "lruGet", "lruPut", "lruTouch", "lruEvict"
+};
+
+static OpStats opStats[OP_COUNT];
+static ListOp currentOp = OP_COUNT;
+
+OpScope opBegin(ListOp op);
+void opEnd(OpScope* scope);
+void dumpStatsJson(FILE* out);
+
+#define LL_OP(op) OpScope opScope_ __attribute__((cleanup(opEnd))) = opBegin(op)
+#define LL_TRAVERSED(n) (currentOp != OP_COUNT ? (void)(opStats[currentOp].nodesTraversed += (n)) : (void)0)
+#define LL_ALLOCATED() (currentOp != OP_COUNT ? (void)opStats[currentOp].allocations++ : (void)0)
+#define LL_FREED() (currentOp != OP_COUNT ? (void)opStats[currentOp].frees++ : (void)0)
+#else
+#define LL_OP(op) ((void)0)
+#define LL_TRAVERSED(n) ((void)0)
+#define LL_ALLOCATED() ((void)0)
+#define LL_FREED() ((void)0)
+#endif
 
 // Node structure for singly linked list
 typedef struct Node {
@@ -14,6 +95,47 @@ typedef struct LinkedList {
     int size;
 } LinkedList;
 
+// LRU cache built on a doubly linked variant of Node. Nodes are carved out
+// of slabs and recycled through a free list, and a chained hash table maps
+// each key to its node, so get/put/touch/evict never walk the list.
+#define LRU_SLAB_NODES 1024
+#define LRU_MIN_BUCKETS 16
+#define LRU_DEFAULT_ENTRIES 8
+
+// Cache entry: linked by recency in both directions and chained in its bucket
+typedef struct LruNode {
+    int key;
+    int value;
+    size_t bytes;
+    struct LruNode* prev;
+    struct LruNode* next;
+    struct LruNode* chain;
+} LruNode;
+
+// Block of nodes allocated at once
+typedef struct LruSlab {
+    struct LruSlab* next;
+    LruNode nodes[LRU_SLAB_NODES];
+} LruSlab;
+
+// LRU cache: most recently used entry at head, evictions from tail.
+// A limit of 0 entries or 0 bytes means that dimension is unbounded.
+typedef struct LruCache {
+    LruNode* head;
+    LruNode* tail;
+    LruNode** buckets;
+    uint32_t bucketMask;
+    LruNode* freeNodes;
+    LruSlab* slabs;
+    int size;
+    int maxEntries;
+    size_t bytes;
+    size_t maxBytes;
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+} LruCache;
+
 // Function prototypes
 LinkedList* createList();
 Node* createNode(int data);
@@ -26,20 +148,134 @@ bool deleteAtPosition(LinkedList* list, int position);
 bool deleteByValue(LinkedList* list, int value);
 void traverseList(LinkedList* list);
 void traverseReverse(LinkedList* list, Node* node);
+static void traverseReverseFrom(LinkedList* list, Node* node);
 int searchElement(LinkedList* list, int value);
 int getSize(LinkedList* list);
 bool isEmpty(LinkedList* list);
 void clearList(LinkedList* list);
 void destroyList(LinkedList* list);
 void displayMenu();
+LruCache* createLruCache(int maxEntries, size_t maxBytes);
+bool lruGet(LruCache* cache, int key, int* value);
+bool lruPut(LruCache* cache, int key, int value, size_t bytes);
+bool lruTouch(LruCache* cache, int key);
+bool lruEvict(LruCache* cache);
+void displayLru(LruCache* cache);
+void destroyLruCache(LruCache* cache);
+void benchmarkLru(int operations);
+
+// Monotonic clock in nanoseconds
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#ifdef LL_INSTRUMENT
+
+// Map a latency to its histogram bucket
+static int histIndex(uint64_t value) {
+    if (value < HIST_SUB_COUNT) {
+        return (int)value;
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - HIST_SUB_BITS;
+    return (shift + 1) * HIST_SUB_COUNT + (int)((value >> shift) & (HIST_SUB_COUNT - 1));
+}
+
+// Smallest latency that falls into a histogram bucket
+static uint64_t histLowerBound(int index) {
+    if (index < 2 * HIST_SUB_COUNT) {
+        return (uint64_t)index;
+    }
+    int shift = index / HIST_SUB_COUNT - 1;
+    return (uint64_t)(HIST_SUB_COUNT + index % HIST_SUB_COUNT) << shift;
+}
+
+// Latency below which the given fraction of calls completed
+static uint64_t histPercentile(const OpStats* stats, double fraction) {
+    uint64_t target = (uint64_t)(fraction * (double)stats->calls);
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += stats->hist[i];
+        if (seen > target) {
+            return histLowerBound(i);
+        }
+    }
+    return stats->maxNs;
+}
+
+// Start measuring an operation; nested operations are measured on their own
+OpScope opBegin(ListOp op) {
+    OpScope scope;
+    scope.op = op;
+    scope.outer = currentOp;
+    currentOp = op;
+    opStats[op].calls++;
+    scope.startNs = nowNs();
+    return scope;
+}
+
+// Record the latency of a finished operation
+void opEnd(OpScope* scope) {
+    uint64_t elapsed = nowNs() - scope->startNs;
+    OpStats* stats = &opStats[scope->op];
+    stats->totalNs += elapsed;
+    if (stats->minNs == 0 || elapsed < stats->minNs) {
+        stats->minNs = elapsed;
+    }
+    if (elapsed > stats->maxNs) {
+        stats->maxNs = elapsed;
+    }
+    stats->hist[histIndex(elapsed)]++;
+    currentOp = scope->outer;
+}
+
+// Write all collected counters and histograms as a JSON document
+void dumpStatsJson(FILE* out) {
+    fprintf(out, "{\n  \"operations\": [");
+    bool first = true;
+    for (int op = 0; op < OP_COUNT; op++) {
+        const OpStats* stats = &opStats[op];
+        if (stats->calls == 0) {
+            continue;
+        }
+        fprintf(out, "%s\n    {\"name\": \"%s\", \"calls\": %llu, \"nodes_traversed\": %llu, "
+                "\"allocations\": %llu, \"frees\": %llu,\n", first ? "" : ",", opNames[op],
+                (unsigned long long)stats->calls, (unsigned long long)stats->nodesTraversed,
+                (unsigned long long)stats->allocations, (unsigned long long)stats->frees);
+        fprintf(out, "     \"latency_ns\": {\"total\": %llu, \"min\": %llu, \"max\": %llu, \"mean\": %llu, "
+                "\"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"p999\": %llu},\n",
+                (unsigned long long)stats->totalNs, (unsigned long long)stats->minNs,
+                (unsigned long long)stats->maxNs, (unsigned long long)(stats->totalNs / stats->calls),
+                (unsigned long long)histPercentile(stats, 0.50), (unsigned long long)histPercentile(stats, 0.90),
+                (unsigned long long)histPercentile(stats, 0.99), (unsigned long long)histPercentile(stats, 0.999));
+        fprintf(out, "     \"histogram\": [");
+        bool firstBucket = true;
+        for (int i = 0; i < HIST_BUCKETS; i++) {
+            if (stats->hist[i] == 0) {
+                continue;
+            }
+            fprintf(out, "%s[%llu, %llu]", firstBucket ? "" : ", ",
+                    (unsigned long long)histLowerBound(i), (unsigned long long)stats->hist[i]);
+            firstBucket = false;
+        }
+        fprintf(out, "]}");
+        first = false;
+    }
+    fprintf(out, "\n  ]\n}\n");
+}
+#endif
 
 // Create a new linked list
 LinkedList* createList() {
+    LL_OP(OP_CREATE_LIST);
     LinkedList* list = (LinkedList*)malloc(sizeof(LinkedList));
     if (list == NULL) {
         printf("Error: Memory allocation failed for list\n");
         return NULL;
     }
+    LL_ALLOCATED();
     list->head = NULL;
     list->size = 0;
     return list;
@@ -52,6 +288,7 @@ Node* createNode(int data) {
         printf("Error: Memory allocation failed for node\n");
         return NULL;
     }
+    LL_ALLOCATED();
     newNode->data = data;
     newNode->next = NULL;
     return newNode;
@@ -59,6 +296,7 @@ Node* createNode(int data) {
 
 // Insert element at the beginning
 void insertAtBeginning(LinkedList* list, int data) {
+    LL_OP(OP_INSERT_BEGINNING);
     if (list == NULL) {
         printf("Error: List is NULL\n");
         return;
@@ -75,6 +313,7 @@ void insertAtBeginning(LinkedList* list, int data) {
 
 // Insert element at the end
 void insertAtEnd(LinkedList* list, int data) {
+    LL_OP(OP_INSERT_END);
     if (list == NULL) {
         printf("Error: List is NULL\n");
         return;
@@ -89,6 +328,7 @@ void insertAtEnd(LinkedList* list, int data) {
         Node* current = list->head;
         while (current->next != NULL) {
             current = current->next;
+            LL_TRAVERSED(1);
         }
         current->next = newNode;
     }
@@ -98,6 +338,7 @@ void insertAtEnd(LinkedList* list, int data) {
 
 // Insert element at specific position (0-indexed)
 void insertAtPosition(LinkedList* list, int data, int position) {
+    LL_OP(OP_INSERT_POSITION);
     if (list == NULL) {
         printf("Error: List is NULL\n");
         return;
@@ -120,6 +361,7 @@ void insertAtPosition(LinkedList* list, int data, int position) {
     for (int i = 0; i < position - 1; i++) {
         current = current->next;
     }
+    LL_TRAVERSED(position - 1);
     
     newNode->next = current->next;
     current->next = newNode;
@@ -129,6 +371,7 @@ void insertAtPosition(LinkedList* list, int data, int position) {
 
 // Delete element from beginning
 bool deleteAtBeginning(LinkedList* list) {
+    LL_OP(OP_DELETE_BEGINNING);
     if (list == NULL || list->head == NULL) {
         printf("Error: List is empty or NULL\n");
         return false;
@@ -138,6 +381,7 @@ bool deleteAtBeginning(LinkedList* list) {
     int data = temp->data;
     list->head = list->head->next;
     free(temp);
+    LL_FREED();
     list->size--;
     printf("Element %d deleted from beginning\n", data);
     return true;
@@ -145,6 +389,7 @@ bool deleteAtBeginning(LinkedList* list) {
 
 // Delete element from end
 bool deleteAtEnd(LinkedList* list) {
+    LL_OP(OP_DELETE_END);
     if (list == NULL || list->head == NULL) {
         printf("Error: List is empty or NULL\n");
         return false;
@@ -157,10 +402,12 @@ bool deleteAtEnd(LinkedList* list) {
     Node* current = list->head;
     while (current->next->next != NULL) {
         current = current->next;
+        LL_TRAVERSED(1);
     }
     
     int data = current->next->data;
     free(current->next);
+    LL_FREED();
     current->next = NULL;
     list->size--;
     printf("Element %d deleted from end\n", data);
@@ -169,6 +416,7 @@ bool deleteAtEnd(LinkedList* list) {
 
 // Delete element at specific position (0-indexed)
 bool deleteAtPosition(LinkedList* list, int position) {
+    LL_OP(OP_DELETE_POSITION);
     if (list == NULL || list->head == NULL) {
         printf("Error: List is empty or NULL\n");
         return false;
@@ -187,11 +435,13 @@ bool deleteAtPosition(LinkedList* list, int position) {
     for (int i = 0; i < position - 1; i++) {
         current = current->next;
     }
+    LL_TRAVERSED(position - 1);
     
     Node* nodeToDelete = current->next;
     int data = nodeToDelete->data;
     current->next = nodeToDelete->next;
     free(nodeToDelete);
+    LL_FREED();
     list->size--;
     printf("Element %d deleted from position %d\n", data, position);
     return true;
@@ -199,6 +449,7 @@ bool deleteAtPosition(LinkedList* list, int position) {
 
 // Delete first occurrence of a value
 bool deleteByValue(LinkedList* list, int value) {
+    LL_OP(OP_DELETE_VALUE);
     if (list == NULL || list->head == NULL) {
         printf("Error: List is empty or NULL\n");
         return false;
@@ -211,6 +462,7 @@ bool deleteByValue(LinkedList* list, int value) {
     Node* current = list->head;
     while (current->next != NULL && current->next->data != value) {
         current = current->next;
+        LL_TRAVERSED(1);
     }
     
     if (current->next == NULL) {
@@ -221,6 +473,7 @@ bool deleteByValue(LinkedList* list, int value) {
     Node* nodeToDelete = current->next;
     current->next = nodeToDelete->next;
     free(nodeToDelete);
+    LL_FREED();
     list->size--;
     printf("Element %d deleted from list\n", value);
     return true;
@@ -228,6 +481,7 @@ bool deleteByValue(LinkedList* list, int value) {
 
 // Traverse and display the list
 void traverseList(LinkedList* list) {
+    LL_OP(OP_TRAVERSE);
     if (list == NULL || list->head == NULL) {
         printf("List is empty\n");
         return;
@@ -241,6 +495,7 @@ void traverseList(LinkedList* list) {
             printf(" -> ");
         }
         current = current->next;
+        LL_TRAVERSED(1);
     }
     printf(" -> NULL\n");
     printf("Size: %d\n", list->size);
@@ -248,6 +503,19 @@ void traverseList(LinkedList* list) {
 
 // Traverse and display the list in reverse (using recursion)
 void traverseReverse(LinkedList* list, Node* node) {
+#ifdef LL_INSTRUMENT
+    // Time the whole walk once, not every recursive step
+    if (list != NULL && node == list->head) {
+        LL_OP(OP_TRAVERSE_REVERSE);
+        traverseReverseFrom(list, node);
+        return;
+    }
+#endif
+    traverseReverseFrom(list, node);
+}
+
+// Recursive worker for traverseReverse
+static void traverseReverseFrom(LinkedList* list, Node* node) {
     if (list == NULL) {
         printf("List is NULL\n");
         return;
@@ -260,12 +528,14 @@ void traverseReverse(LinkedList* list, Node* node) {
         return;
     }
     
-    traverseReverse(list, node->next);
+    LL_TRAVERSED(1);
+    traverseReverseFrom(list, node->next);
     printf("%d ", node->data);
 }
 
 // Search for an element and return its position (-1 if not found)
 int searchElement(LinkedList* list, int value) {
+    LL_OP(OP_SEARCH);
     if (list == NULL || list->head == NULL) {
         return -1;
     }
@@ -280,6 +550,7 @@ int searchElement(LinkedList* list, int value) {
         }
         current = current->next;
         position++;
+        LL_TRAVERSED(1);
     }
     
     printf("Element %d not found in list\n", value);
@@ -301,6 +572,7 @@ bool isEmpty(LinkedList* list) {
 
 // Clear all elements from the list
 void clearList(LinkedList* list) {
+    LL_OP(OP_CLEAR);
     if (list == NULL) {
         return;
     }
@@ -309,6 +581,7 @@ void clearList(LinkedList* list) {
     while (current != NULL) {
         Node* next = current->next;
         free(current);
+        LL_FREED();
         current = next;
     }
     
@@ -319,15 +592,294 @@ void clearList(LinkedList* list) {
 
 // Destroy the entire list structure
 void destroyList(LinkedList* list) {
+    LL_OP(OP_DESTROY);
     if (list == NULL) {
         return;
     }
     
     clearList(list);
     free(list);
+    LL_FREED();
     printf("List destroyed successfully\n");
 }
 
+// Find the link that points at key's node, or at the end of its chain
+static LruNode** lruSlot(LruCache* cache, int key) {
+    uint32_t hash = (uint32_t)key * 0x9E3779B1u;
+    LruNode** slot = &cache->buckets[(hash ^ (hash >> 16)) & cache->bucketMask];
+    while (*slot != NULL && (*slot)->key != key) {
+        slot = &(*slot)->chain;
+    }
+    return slot;
+}
+
+// Detach a node from the recency list
+static void lruUnlink(LruCache* cache, LruNode* node) {
+    if (node->prev != NULL) {
+        node->prev->next = node->next;
+    } else {
+        cache->head = node->next;
+    }
+    if (node->next != NULL) {
+        node->next->prev = node->prev;
+    } else {
+        cache->tail = node->prev;
+    }
+}
+
+// Make a node the most recently used
+static void lruPushFront(LruCache* cache, LruNode* node) {
+    node->prev = NULL;
+    node->next = cache->head;
+    if (cache->head != NULL) {
+        cache->head->prev = node;
+    } else {
+        cache->tail = node;
+    }
+    cache->head = node;
+}
+
+// Take a node from the free list, adding a slab when it runs dry
+static LruNode* lruAllocNode(LruCache* cache) {
+    if (cache->freeNodes == NULL) {
+        LruSlab* slab = (LruSlab*)malloc(sizeof(LruSlab));
+        if (slab == NULL) {
+            printf("Error: Memory allocation failed for cache nodes\n");
+            return NULL;
+        }
+        LL_ALLOCATED();
+        slab->next = cache->slabs;
+        cache->slabs = slab;
+        for (int i = LRU_SLAB_NODES - 1; i >= 0; i--) {
+            slab->nodes[i].next = cache->freeNodes;
+            cache->freeNodes = &slab->nodes[i];
+        }
+    }
+    LruNode* node = cache->freeNodes;
+    cache->freeNodes = node->next;
+    return node;
+}
+
+// Double the bucket array once the load factor passes 1; on allocation
+// failure the cache keeps working with longer chains
+static void lruGrow(LruCache* cache) {
+    uint32_t count = (cache->bucketMask + 1) * 2;
+    LruNode** buckets = (LruNode**)calloc(count, sizeof(LruNode*));
+    if (buckets == NULL) {
+        return;
+    }
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucketMask = count - 1;
+    for (LruNode* node = cache->head; node != NULL; node = node->next) {
+        LruNode** slot = lruSlot(cache, node->key);
+        node->chain = NULL;
+        *slot = node;
+    }
+}
+
+// Remove the node a hash slot points at and return it to the free list
+static void lruRemove(LruCache* cache, LruNode** slot) {
+    LruNode* node = *slot;
+    *slot = node->chain;
+    lruUnlink(cache, node);
+    cache->size--;
+    cache->bytes -= node->bytes;
+    node->next = cache->freeNodes;
+    cache->freeNodes = node;
+}
+
+// Create an empty LRU cache with the given limits
+LruCache* createLruCache(int maxEntries, size_t maxBytes) {
+    if (maxEntries < 0 || (maxEntries == 0 && maxBytes == 0)) {
+        printf("Error: Cache needs a limit on entries or bytes\n");
+        return NULL;
+    }
+    LruCache* cache = (LruCache*)calloc(1, sizeof(LruCache));
+    if (cache == NULL) {
+        printf("Error: Memory allocation failed for cache\n");
+        return NULL;
+    }
+    cache->buckets = (LruNode**)calloc(LRU_MIN_BUCKETS, sizeof(LruNode*));
+    if (cache->buckets == NULL) {
+        printf("Error: Memory allocation failed for cache\n");
+        free(cache);
+        return NULL;
+    }
+    LL_ALLOCATED();
+    cache->bucketMask = LRU_MIN_BUCKETS - 1;
+    cache->maxEntries = maxEntries;
+    cache->maxBytes = maxBytes;
+    return cache;
+}
+
+// Look up a key, marking it most recently used on a hit
+bool lruGet(LruCache* cache, int key, int* value) {
+    LL_OP(OP_LRU_GET);
+    if (cache == NULL) {
+        return false;
+    }
+    LruNode* node = *lruSlot(cache, key);
+    if (node == NULL) {
+        cache->misses++;
+        return false;
+    }
+    cache->hits++;
+    if (node != cache->head) {
+        lruUnlink(cache, node);
+        lruPushFront(cache, node);
+    }
+    *value = node->value;
+    return true;
+}
+
+// Insert or update a key, evicting least recently used entries to stay
+// within the limits
+bool lruPut(LruCache* cache, int key, int value, size_t bytes) {
+    LL_OP(OP_LRU_PUT);
+    if (cache == NULL) {
+        printf("Error: Cache is NULL\n");
+        return false;
+    }
+    if (cache->maxBytes != 0 && bytes > cache->maxBytes) {
+        printf("Error: Entry of %zu bytes exceeds cache capacity of %zu bytes\n", bytes, cache->maxBytes);
+        return false;
+    }
+    LruNode** slot = lruSlot(cache, key);
+    LruNode* node = *slot;
+    if (node != NULL) {
+        cache->bytes -= node->bytes;
+        if (node != cache->head) {
+            lruUnlink(cache, node);
+            lruPushFront(cache, node);
+        }
+    } else {
+        node = lruAllocNode(cache);
+        if (node == NULL) return false;
+        node->key = key;
+        node->chain = NULL;
+        *slot = node;
+        lruPushFront(cache, node);
+        cache->size++;
+    }
+    node->value = value;
+    node->bytes = bytes;
+    cache->bytes += bytes;
+
+    while ((cache->maxEntries != 0 && cache->size > cache->maxEntries) ||
+           (cache->maxBytes != 0 && cache->bytes > cache->maxBytes)) {
+        lruEvict(cache);
+    }
+    if ((uint32_t)cache->size > cache->bucketMask + 1) {
+        lruGrow(cache);
+    }
+    return true;
+}
+
+// Mark a key most recently used without reading it or counting a hit
+bool lruTouch(LruCache* cache, int key) {
+    LL_OP(OP_LRU_TOUCH);
+    if (cache == NULL) {
+        return false;
+    }
+    LruNode* node = *lruSlot(cache, key);
+    if (node == NULL) {
+        return false;
+    }
+    if (node != cache->head) {
+        lruUnlink(cache, node);
+        lruPushFront(cache, node);
+    }
+    return true;
+}
+
+// Drop the least recently used entry
+bool lruEvict(LruCache* cache) {
+    LL_OP(OP_LRU_EVICT);
+    if (cache == NULL || cache->tail == NULL) {
+        return false;
+    }
+    lruRemove(cache, lruSlot(cache, cache->tail->key));
+    cache->evictions++;
+    return true;
+}
+
+// Print entries from most to least recently used, followed by the counters
+void displayLru(LruCache* cache) {
+    if (cache == NULL) {
+        printf("Cache is NULL\n");
+        return;
+    }
+    if (cache->head == NULL) {
+        printf("Cache is empty\n");
+    } else {
+        printf("Cache (MRU -> LRU): ");
+        for (LruNode* node = cache->head; node != NULL; node = node->next) {
+            printf("%d=%d(%zuB)%s", node->key, node->value, node->bytes, node->next != NULL ? " -> " : "\n");
+        }
+    }
+    unsigned long long lookups = cache->hits + cache->misses;
+    printf("Entries: %d", cache->size);
+    if (cache->maxEntries != 0) {
+        printf(" of %d", cache->maxEntries);
+    }
+    printf(", bytes: %zu", cache->bytes);
+    if (cache->maxBytes != 0) {
+        printf(" of %zu", cache->maxBytes);
+    }
+    printf("\nHits: %llu, misses: %llu (hit rate %.1f%%), evictions: %llu\n", cache->hits, cache->misses,
+           lookups != 0 ? 100.0 * cache->hits / lookups : 0.0, cache->evictions);
+}
+
+// Free the cache and all of its slabs
+void destroyLruCache(LruCache* cache) {
+    if (cache == NULL) {
+        return;
+    }
+    while (cache->slabs != NULL) {
+        LruSlab* next = cache->slabs->next;
+        free(cache->slabs);
+        LL_FREED();
+        cache->slabs = next;
+    }
+    free(cache->buckets);
+    free(cache);
+    LL_FREED();
+}
+
+// Cache-aside workload: look a key up and insert it on a miss. Three in
+// four lookups go to a hot set half the size of the cache, the rest are
+// spread over a key space four times larger than the cache.
+void benchmarkLru(int operations) {
+    const int capacity = 1 << 16;
+    LruCache* cache = createLruCache(capacity, 0);
+    if (cache == NULL) return;
+
+    uint32_t state = 2463534242u;
+    long long checksum = 0;
+    uint64_t start = nowNs();
+    for (int i = 0; i < operations; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        int key = (state & 3) != 0 ? (int)((state >> 2) % (capacity / 2)) : (int)((state >> 2) % (capacity * 4));
+        int value;
+        if (lruGet(cache, key, &value)) {
+            checksum += value;
+        } else if (!lruPut(cache, key, key, sizeof(int))) {
+            break;
+        }
+    }
+    uint64_t elapsed = nowNs() - start;
+
+    double seconds = elapsed / 1e9;
+    printf("%d operations on a %d entry cache in %.3f s: %.2f M ops/s, %.1f ns/op\n", operations, capacity,
+           seconds, seconds > 0 ? operations / seconds / 1e6 : 0.0, operations != 0 ? (double)elapsed / operations : 0.0);
+    printf("Hits: %llu, misses: %llu (hit rate %.1f%%), evictions: %llu, checksum %lld\n", cache->hits,
+           cache->misses, operations != 0 ? 100.0 * cache->hits / operations : 0.0, cache->evictions, checksum);
+    destroyLruCache(cache);
+}
+
 // Display menu options
 void displayMenu() {
     printf("\n=== SINGLY LINKED LIST OPERATIONS ===\n");
@@ -344,6 +896,16 @@ void displayMenu() {
     printf("11. Get list size\n");
     printf("12. Check if empty\n");
     printf("13. Clear list\n");
+#ifdef LL_INSTRUMENT
+    printf("14. Dump instrumentation stats (JSON)\n");
+#endif
+    printf("15. Create LRU cache\n");
+    printf("16. LRU cache put\n");
+    printf("17. LRU cache get\n");
+    printf("18. LRU cache touch\n");
+    printf("19. LRU cache evict oldest\n");
+    printf("20. Display LRU cache\n");
+    printf("21. Benchmark LRU cache\n");
     printf("0.  Exit\n");
     printf("=====================================\n");
     printf("Enter your choice: ");
@@ -357,7 +919,9 @@ int main() {
         return 1;
     }
     
+    LruCache* cache = createLruCache(LRU_DEFAULT_ENTRIES, 0);
     int choice, data, position;
+    unsigned long bytes;
     
     printf("Singly Linked List Implementation in C\n");
     printf("======================================\n");
@@ -435,8 +999,75 @@ int main() {
                 clearList(list);
                 break;
                 
+#ifdef LL_INSTRUMENT
+            case 14:
+                dumpStatsJson(stdout);
+                break;
+#endif
+                
+            case 15:
+                printf("Enter maximum entries (0 for no limit): ");
+                scanf("%d", &position);
+                printf("Enter maximum bytes (0 for no limit): ");
+                scanf("%lu", &bytes);
+                LruCache* created = createLruCache(position, bytes);
+                if (created != NULL) {
+                    destroyLruCache(cache);
+                    cache = created;
+                    printf("LRU cache created\n");
+                }
+                break;
+                
+            case 16:
+                printf("Enter key: ");
+                scanf("%d", &position);
+                printf("Enter value: ");
+                scanf("%d", &data);
+                printf("Enter size in bytes: ");
+                scanf("%lu", &bytes);
+                if (lruPut(cache, position, data, bytes)) {
+                    printf("Key %d stored\n", position);
+                }
+                break;
+                
+            case 17:
+                printf("Enter key: ");
+                scanf("%d", &position);
+                if (lruGet(cache, position, &data)) {
+                    printf("Key %d has value %d\n", position, data);
+                } else {
+                    printf("Key %d not in cache\n", position);
+                }
+                break;
+                
+            case 18:
+                printf("Enter key: ");
+                scanf("%d", &position);
+                printf(lruTouch(cache, position) ? "Key %d touched\n" : "Key %d not in cache\n", position);
+                break;
+                
+            case 19:
+                if (cache != NULL && cache->tail != NULL) {
+                    printf("Evicting key %d\n", cache->tail->key);
+                }
+                if (!lruEvict(cache)) {
+                    printf("Cache is empty\n");
+                }
+                break;
+                
+            case 20:
+                displayLru(cache);
+                break;
+                
+            case 21:
+                printf("Enter number of operations: ");
+                scanf("%d", &data);
+                benchmarkLru(data);
+                break;
+                
             case 0:
                 printf("Exiting program...\n");
+                destroyLruCache(cache);
                 destroyList(list);
                 return 0;
                 
@@ -1,67 +1,3065 @@
+#define _GNU_SOURCE
+#define _FILE_OFFSET_BITS 64
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+
+// Plain stream layout: a 4 byte magic followed by a sequence of ops.
+// Each op starts with a control byte:
+//   0x00-0x7F  literal: (c + 1) raw bytes follow
+//   0x80-0xFE  run: one byte follows, repeated (c - 0x80 + RLE_MIN_RUN) times
+//   0xFF       long run: a LEB128 varint n follows, then one byte repeated
+//              (n + RLE_LONG_RUN) times
+// Every byte value is stored verbatim, so any binary input round-trips.
+#define RLE_MAGIC "RLE\x01"
+#define RLE_MAGIC_SIZE 4
+#define RLE_MIN_RUN 3
+#define RLE_MAX_LITERAL 128
+#define RLE_LONG_RUN (RLE_MIN_RUN + 0x7F)
+#define RLE_MAX_OP_SIZE (1 + RLE_MAX_LITERAL)
+#define RLE_BUFFER_SIZE (1 << 20)
+
+// Worst case encoded size of n input bytes
+size_t rle_encode_bound(size_t n) {
+    return n + n / RLE_MAX_LITERAL + 16;
+}
+
+// Run detection kernels. rle_run_length returns how many bytes at the
+// start of p equal p[0]; rle_find_run returns the offset of the first run
+// of RLE_MIN_RUN equal bytes (or n if there is none), i.e. the length of
+// the literal span in front of it. The x86 versions compare a whole
+// vector against the run byte (or against itself shifted by one and two
+// bytes) and locate the first mismatch with movemask + ctz.
+static size_t rle_run_length_scalar(const uint8_t *p, size_t n) {
+    size_t i = 1;
+    while (i < n && p[i] == p[0]) {
+        i++;
+    }
+    return i;
+}
+
+static size_t rle_find_run_scalar(const uint8_t *p, size_t n) {
+    for (size_t i = 0; i + 2 < n; i++) {
+        if (p[i] == p[i + 1] && p[i + 1] == p[i + 2]) {
+            return i;
+        }
+    }
+    return n;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+__attribute__((target("sse2")))
+static size_t rle_run_length_sse2(const uint8_t *p, size_t n) {
+    __m128i value = _mm_set1_epi8((char)p[0]);
+    size_t i = 1;
+    while (i + 16 <= n) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(p + i));
+        unsigned mask = ~(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, value)) & 0xFFFF;
+        if (mask) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+        i += 16;
+    }
+    while (i < n && p[i] == p[0]) {
+        i++;
+    }
+    return i;
+}
+
+__attribute__((target("sse2")))
+static size_t rle_find_run_sse2(const uint8_t *p, size_t n) {
+    size_t i = 0;
+    while (i + 18 <= n) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(p + i + 1));
+        __m128i c = _mm_loadu_si128((const __m128i *)(p + i + 2));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, b), _mm_cmpeq_epi8(b, c)));
+        if (mask) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+        i += 16;
+    }
+    size_t tail = rle_find_run_scalar(p + i, n - i);
+    return i + tail;
+}
+
+__attribute__((target("avx2")))
+static size_t rle_run_length_avx2(const uint8_t *p, size_t n) {
+    __m256i value = _mm256_set1_epi8((char)p[0]);
+    size_t i = 1;
+    while (i + 32 <= n) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(p + i));
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, value));
+        if (mask) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+        i += 32;
+    }
+    while (i < n && p[i] == p[0]) {
+        i++;
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t rle_find_run_avx2(const uint8_t *p, size_t n) {
+    size_t i = 0;
+    while (i + 34 <= n) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(p + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(p + i + 1));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(p + i + 2));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, b), _mm256_cmpeq_epi8(b, c)));
+        if (mask) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+        i += 32;
+    }
+    size_t tail = rle_find_run_scalar(p + i, n - i);
+    return i + tail;
+}
+#endif
+
+static size_t (*rle_run_length)(const uint8_t *p, size_t n) = rle_run_length_scalar;
+static size_t (*rle_find_run)(const uint8_t *p, size_t n) = rle_find_run_scalar;
+
+// Pick the widest kernel the CPU supports
+void rle_init_kernels(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        rle_run_length = rle_run_length_avx2;
+        rle_find_run = rle_find_run_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        rle_run_length = rle_run_length_sse2;
+        rle_find_run = rle_find_run_sse2;
+    }
+#endif
+}
+
+// Emit literal ops for n raw bytes
+static uint8_t *rle_put_literals(uint8_t *out, const uint8_t *p, size_t n) {
+    while (n > 0) {
+        size_t chunk = n < RLE_MAX_LITERAL ? n : RLE_MAX_LITERAL;
+        *out++ = (uint8_t)(chunk - 1);
+        memcpy(out, p, chunk);
+        out += chunk;
+        p += chunk;
+        n -= chunk;
+    }
+    return out;
+}
+
+// Emit a run op for count (>= RLE_MIN_RUN) copies of value
+static uint8_t *rle_put_run(uint8_t *out, uint8_t value, size_t count) {
+    if (count < RLE_LONG_RUN) {
+        *out++ = (uint8_t)(0x80 + count - RLE_MIN_RUN);
+    } else {
+        size_t extra = count - RLE_LONG_RUN;
+        *out++ = 0xFF;
+        while (extra >= 0x80) {
+            *out++ = (uint8_t)(extra | 0x80);
+            extra >>= 7;
+        }
+        *out++ = (uint8_t)extra;
+    }
+    *out++ = value;
+    return out;
+}
+
+// Encode n bytes into out (at least rle_encode_bound(n) bytes); returns the encoded size
+size_t rle_encode(const uint8_t *in, size_t n, uint8_t *out) {
+    uint8_t *start = out;
+    size_t literal = 0;
+    size_t i = 0;
+
+    while (i < n) {
+        i += rle_find_run(in + i, n - i);
+        if (i == n) {
+            break;
+        }
+        size_t run = rle_run_length(in + i, n - i);
+        out = rle_put_literals(out, in + literal, i - literal);
+        out = rle_put_run(out, in[i], run);
+        i += run;
+        literal = i;
+    }
+    out = rle_put_literals(out, in + literal, n - literal);
+    return (size_t)(out - start);
+}
+
+// Parse the op at in[0..n). Returns the op size, 0 if the op is truncated
+// or -1 if it is malformed. Literals set *data to the raw bytes, runs set
+// *data to the repeated byte; *count is the number of output bytes.
+static long rle_parse_op(const uint8_t *in, size_t n, int *is_run, const uint8_t **data, size_t *count) {
+    if (n == 0) {
+        return 0;
+    }
+    uint8_t c = in[0];
+    if (c < 0x80) {
+        if (n < (size_t)c + 2) {
+            return 0;
+        }
+        *is_run = 0;
+        *data = in + 1;
+        *count = (size_t)c + 1;
+        return (long)c + 2;
+    }
+    if (c < 0xFF) {
+        if (n < 2) {
+            return 0;
+        }
+        *is_run = 1;
+        *data = in + 1;
+        *count = (size_t)(c - 0x80) + RLE_MIN_RUN;
+        return 2;
+    }
+
+    size_t extra = 0;
+    size_t pos = 1;
+    int shift = 0;
+    while (1) {
+        if (pos >= n) {
+            return 0;
+        }
+        if (shift > 63) {
+            return -1;
+        }
+        uint8_t b = in[pos++];
+        extra |= (size_t)(b & 0x7F) << shift;
+        shift += 7;
+        if (!(b & 0x80)) {
+            break;
+        }
+    }
+    if (pos >= n) {
+        return 0;
+    }
+    *is_run = 1;
+    *data = in + pos;
+    *count = extra + RLE_LONG_RUN;
+    return (long)pos + 1;
+}
+
+// Store 32 copies of value at p with two broadcast vector stores
+static inline void rle_splat32(uint8_t *p, uint8_t value) {
+#if defined(__SSE2__)
+    __m128i v = _mm_set1_epi8((char)value);
+    _mm_storeu_si128((__m128i *)p, v);
+    _mm_storeu_si128((__m128i *)(p + 16), v);
+#else
+    memset(p, value, 32);
+#endif
+}
+
+// Decode a complete op stream into out; returns the decoded size or -1 if
+// the stream is malformed or does not fit in cap bytes
+long rle_decode(const uint8_t *in, size_t n, uint8_t *out, size_t cap) {
+    size_t pos = 0;
+    size_t written = 0;
+
+    while (pos < n) {
+        int is_run;
+        const uint8_t *data;
+        size_t count;
+        long size = rle_parse_op(in + pos, n - pos, &is_run, &data, &count);
+        if (size <= 0 || count > cap - written) {
+            return -1;
+        }
+        // Short ops are expanded with one fixed 32 byte store instead of a
+        // memset/memcpy call. The store may run past the op only when the
+        // ops that follow are sure to overwrite those bytes: every op
+        // decodes to at least half its encoded size, so 64 more input bytes
+        // mean at least 32 more output bytes. Bytes past the decoded size
+        // are never touched.
+        int spill = n - pos - (size_t)size >= 64 && cap - written >= 32;
+        if (is_run) {
+            if (count >= 32 || spill) {
+                rle_splat32(out + written, *data);
+                if (count > 32) {
+                    memset(out + written + 32, *data, count - 32);
+                }
+            } else {
+                memset(out + written, *data, count);
+            }
+        } else {
+            if (count <= 32 && spill) {
+                memcpy(out + written, data, 32);
+            } else {
+                memcpy(out + written, data, count);
+            }
+        }
+        written += count;
+        pos += (size_t)size;
+    }
+    return (long)written;
+}
+
+// read() until the buffer is full or EOF; returns bytes read or -1
+static ssize_t read_full(int fd, uint8_t *buf, size_t n) {
+    size_t done = 0;
+    while (done < n) {
+        ssize_t r = read(fd, buf + done, n - done);
+        if (r < 0) {
+            return -1;
+        }
+        if (r == 0) {
+            break;
+        }
+        done += (size_t)r;
+    }
+    return (ssize_t)done;
+}
+
+// write() the whole buffer; returns 0 or -1
+static int write_full(int fd, const uint8_t *buf, size_t n) {
+    while (n > 0) {
+        ssize_t w = write(fd, buf, n);
+        if (w < 0) {
+            return -1;
+        }
+        buf += w;
+        n -= (size_t)w;
+    }
+    return 0;
+}
+
+// Status codes shared by the file level routines
+#define RLE_OK 0
+#define RLE_ERR_IO -1
+#define RLE_ERR_CORRUPT -2
+#define RLE_ERR_FORMAT -3
+#define RLE_ERR_NOMEM -4
+#define RLE_ERR_ARG -5
+
+// Print the outcome of a file level operation
+static int rle_report(int status, const char *success) {
+    switch (status) {
+        case RLE_OK:
+            printf("%s\n", success);
+            break;
+        case RLE_ERR_CORRUPT:
+            printf("Corrupt compressed data.\n");
+            break;
+        case RLE_ERR_FORMAT:
+            printf("Not an RLE compressed file.\n");
+            break;
+        case RLE_ERR_NOMEM:
+            printf("Out of memory.\n");
+            break;
+        case RLE_ERR_ARG:
+            printf("Invalid block or output buffer too small.\n");
+            break;
+        default:
+            printf("File error.\n");
+    }
+    return status;
+}
+
+// Streaming codec over caller supplied buffers. The encoder keeps at most
+// one literal op and one open run between calls and the decoder at most
+// one partial op, so runs and ops may span chunk boundaries freely. Both
+// read and write the plain stream layout, RLE_MAGIC included.
+typedef struct {
+    int header_done;
+    uint8_t literal[RLE_MAX_LITERAL];
+    size_t literal_len;
+    uint8_t run_byte;
+    size_t run_len;
+} RleEncoder;
+
+typedef struct {
+    uint8_t magic[RLE_MAGIC_SIZE];
+    size_t magic_len;
+    uint8_t pending[RLE_MAX_OP_SIZE];
+    size_t pending_len;
+    uint8_t literal[RLE_MAX_LITERAL];
+    size_t literal_pos;
+    int is_run;
+    uint8_t run_byte;
+    size_t remaining;
+} RleDecoder;
+
+// Output space rle_encoder_update or rle_encoder_finish may need for n input bytes
+size_t rle_encoder_bound(size_t n) {
+    return rle_encode_bound(n) + RLE_MAGIC_SIZE + RLE_MAX_OP_SIZE;
+}
+
+void rle_encoder_init(RleEncoder *enc) {
+    memset(enc, 0, sizeof(*enc));
+}
+
+// Move n bytes into the pending literal op, emitting it whenever it fills
+static uint8_t *rle_encoder_literals(RleEncoder *enc, uint8_t *out, const uint8_t *p, size_t n) {
+    while (n > 0) {
+        size_t take = RLE_MAX_LITERAL - enc->literal_len;
+        if (take > n) {
+            take = n;
+        }
+        memcpy(enc->literal + enc->literal_len, p, take);
+        enc->literal_len += take;
+        p += take;
+        n -= take;
+        if (enc->literal_len == RLE_MAX_LITERAL) {
+            out = rle_put_literals(out, enc->literal, enc->literal_len);
+            enc->literal_len = 0;
+        }
+    }
+    return out;
+}
+
+// Emit the open run, or fold it into the literal op if it is too short
+static uint8_t *rle_encoder_close_run(RleEncoder *enc, uint8_t *out) {
+    if (enc->run_len >= RLE_MIN_RUN) {
+        out = rle_put_literals(out, enc->literal, enc->literal_len);
+        enc->literal_len = 0;
+        out = rle_put_run(out, enc->run_byte, enc->run_len);
+    } else if (enc->run_len > 0) {
+        uint8_t bytes[RLE_MIN_RUN];
+        memset(bytes, enc->run_byte, enc->run_len);
+        out = rle_encoder_literals(enc, out, bytes, enc->run_len);
+    }
+    enc->run_len = 0;
+    return out;
+}
+
+// Encode a chunk into out (at least rle_encoder_bound(n) bytes); returns bytes written
+size_t rle_encoder_update(RleEncoder *enc, const uint8_t *in, size_t n, uint8_t *out) {
+    uint8_t *start = out;
+    size_t i = 0;
+
+    if (!enc->header_done) {
+        memcpy(out, RLE_MAGIC, RLE_MAGIC_SIZE);
+        out += RLE_MAGIC_SIZE;
+        enc->header_done = 1;
+    }
+    while (i < n) {
+        if (enc->run_len > 0) {
+            if (in[i] == enc->run_byte) {
+                size_t run = rle_run_length(in + i, n - i);
+                enc->run_len += run;
+                i += run;
+                continue;
+            }
+            out = rle_encoder_close_run(enc, out);
+        }
+        // The last byte of a chunk stays open, as the next chunk may extend it
+        size_t span = rle_find_run(in + i, n - i);
+        if (span == n - i) {
+            span--;
+        }
+        out = rle_encoder_literals(enc, out, in + i, span);
+        i += span;
+        enc->run_byte = in[i];
+        enc->run_len = 1;
+        i++;
+    }
+    return (size_t)(out - start);
+}
+
+// Flush the open run and literal op; returns bytes written (at most rle_encoder_bound(0))
+size_t rle_encoder_finish(RleEncoder *enc, uint8_t *out) {
+    size_t header = rle_encoder_update(enc, NULL, 0, out);
+    uint8_t *end = rle_encoder_close_run(enc, out + header);
+    end = rle_put_literals(end, enc->literal, enc->literal_len);
+    enc->literal_len = 0;
+    return (size_t)(end - out);
+}
+
+void rle_decoder_init(RleDecoder *dec) {
+    memset(dec, 0, sizeof(*dec));
+}
+
+// Load a parsed op as the one being emitted
+static void rle_decoder_start_op(RleDecoder *dec, int is_run, const uint8_t *data, size_t count) {
+    dec->is_run = is_run;
+    dec->remaining = count;
+    if (is_run) {
+        dec->run_byte = *data;
+    } else {
+        memcpy(dec->literal, data, count);
+        dec->literal_pos = 0;
+    }
+}
+
+// Decode from in[0..n) into out[0..cap). Sets *consumed to the input used
+// and returns the number of bytes produced, or a negative status. When
+// the result equals cap, call again with the unconsumed input.
+long rle_decoder_update(RleDecoder *dec, const uint8_t *in, size_t n, size_t *consumed, uint8_t *out, size_t cap) {
+    size_t pos = 0;
+    size_t used = 0;
+
+    while (dec->magic_len < RLE_MAGIC_SIZE && pos < n) {
+        dec->magic[dec->magic_len++] = in[pos++];
+    }
+    if (dec->magic_len == RLE_MAGIC_SIZE && memcmp(dec->magic, RLE_MAGIC, RLE_MAGIC_SIZE) != 0) {
+        return RLE_ERR_FORMAT;
+    }
+
+    while (dec->magic_len == RLE_MAGIC_SIZE) {
+        if (dec->remaining > 0) {
+            size_t chunk = cap - used;
+            if (chunk > dec->remaining) {
+                chunk = dec->remaining;
+            }
+            if (dec->is_run) {
+                memset(out + used, dec->run_byte, chunk);
+            } else {
+                memcpy(out + used, dec->literal + dec->literal_pos, chunk);
+                dec->literal_pos += chunk;
+            }
+            used += chunk;
+            dec->remaining -= chunk;
+            if (dec->remaining > 0) {
+                break;
+            }
+        }
+        if (pos == n) {
+            break;
+        }
+
+        int is_run;
+        const uint8_t *data;
+        size_t count;
+        long size;
+        if (dec->pending_len > 0) {
+            // Complete the op that straddled the previous chunk
+            size_t take = sizeof(dec->pending) - dec->pending_len;
+            if (take > n - pos) {
+                take = n - pos;
+            }
+            memcpy(dec->pending + dec->pending_len, in + pos, take);
+            size = rle_parse_op(dec->pending, dec->pending_len + take, &is_run, &data, &count);
+            if (size == 0) {
+                dec->pending_len += take;
+                pos += take;
+                break;
+            }
+            if (size > 0) {
+                pos += (size_t)size - dec->pending_len;
+                dec->pending_len = 0;
+            }
+        } else {
+            size = rle_parse_op(in + pos, n - pos, &is_run, &data, &count);
+            if (size == 0) {
+                memcpy(dec->pending, in + pos, n - pos);
+                dec->pending_len = n - pos;
+                pos = n;
+                break;
+            }
+            if (size > 0) {
+                pos += (size_t)size;
+            }
+        }
+        if (size < 0) {
+            return RLE_ERR_CORRUPT;
+        }
+        rle_decoder_start_op(dec, is_run, data, count);
+    }
+    *consumed = pos;
+    return (long)used;
+}
+
+// Check that the stream ended on an op boundary
+int rle_decoder_finish(RleDecoder *dec) {
+    if (dec->magic_len != RLE_MAGIC_SIZE || dec->pending_len > 0 || dec->remaining > 0) {
+        return RLE_ERR_CORRUPT;
+    }
+    return RLE_OK;
+}
+
+// Little endian field helpers for the container headers
+static void put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+// Framed container: a header, independently coded blocks and a trailing
+// block index, so blocks can be coded in parallel and read at random.
+//   header  magic "RLEF", u32 block_size, u32 block_count,
+//           u64 total_size, u64 index_offset,
+//           u32 run_interval, u64 run_index_offset
+//   block   u8 method, u32 raw_size, u32 coded_size, coded_size bytes
+//   index   block_count x (u64 block offset, u32 block size, u32 raw_size)
+// The block size in the index counts the block header; the method says
+// whether the payload is raw bytes, RLE ops or Huffman coded RLE ops.
+// Block i holds raw bytes [i * block_size, i * block_size + raw_size).
+//
+// With a run_interval K > 0 the file also carries a sparse run index that
+// lets readers start decoding in the middle of a block:
+//   run index  (block_count + 1) x u64 first entry of each block,
+//              then entries of (u32 raw offset, u32 op stream offset)
+// Each block lists every K-th op of its op stream; for Huffman blocks the
+// offsets refer to the decoded op stream.
+#define RLE_FRAME_MAGIC "RLEF"
+#define RLE_FRAME_HEADER_SIZE 40
+#define RLE_RUN_ENTRY_SIZE 8
+#define RLE_BLOCK_HEADER_SIZE 9
+#define RLE_INDEX_ENTRY_SIZE 16
+#define RLE_DEFAULT_BLOCK_SIZE (1u << 20)
+#define RLE_MAX_BLOCK_SIZE (256u << 20)
+
+// Index entry of one block
+typedef struct {
+    uint64_t offset;
+    uint32_t coded_size;
+    uint32_t raw_size;
+} RleBlockInfo;
+
+// Open framed file for random access
+typedef struct {
+    int fd;
+    uint32_t block_size;
+    uint32_t block_count;
+    uint64_t total_size;
+    RleBlockInfo *index;
+    uint32_t run_interval;
+    uint64_t run_index_offset;
+    uint64_t *run_start;
+} RleFile;
+
+// Second stage: a static canonical Huffman code over the bytes of a
+// block's op stream (control bytes, run lengths and literals alike).
+// Codes are limited to HUF_MAX_BITS so one table lookup decodes a symbol,
+// and the symbols are split over HUF_STREAMS independent bitstreams so
+// the decoder can work on all of them at once instead of waiting on one
+// long serial chain of table lookups.
+//   payload  u32 op stream size, 128 bytes of 4 bit code lengths,
+//            u32 byte size of each stream but the last, the streams
+#define HUF_MAX_BITS 11
+#define HUF_TABLE_SIZE (1 << HUF_MAX_BITS)
+#define HUF_STREAMS 4
+#define HUF_HEADER_SIZE (4 + 128 + 4 * (HUF_STREAMS - 1))
+
+// Decode table entry, indexed by the next HUF_LOOKUP_BITS bits. Where
+// they hold two whole codes, one lookup yields both symbols:
+//   bits 0-7 first symbol, 8-15 second symbol, 16-19 bits of both codes,
+//   20-21 symbol count (1 or 2), 24-27 length of the first code
+typedef uint32_t HufEntry;
+
+#define HUF_ENTRY_BITS(e) (((e) >> 16) & 0xF)
+#define HUF_ENTRY_SYMBOLS(e) (((e) >> 20) & 0x3)
+#define HUF_ENTRY_FIRST_BITS(e) (((e) >> 24) & 0xF)
+// The decode window is one bit wider than the longest code so that pairs
+// of mid-length codes still fit into one lookup
+#define HUF_LOOKUP_BITS (HUF_MAX_BITS + 1)
+#define HUF_LOOKUP_SIZE (1 << HUF_LOOKUP_BITS)
+// Lookups per 64 bit load (at least 57 fresh bits) and the most symbols
+// and bits one fast round can take
+#define HUF_ROUND_LOOKUPS 4
+#define HUF_ROUND_SYMBOLS (2 * HUF_ROUND_LOOKUPS)
+#define HUF_ROUND_BITS (HUF_LOOKUP_BITS * HUF_ROUND_LOOKUPS)
+
+// Compute length-limited Huffman code lengths for the given frequencies
+static void huf_build_lengths(const uint64_t freq[256], uint8_t len[256]) {
+    uint64_t weight[512];
+    int parent[512];
+    int alive[512];
+    int nodes = 256;
+    int used = 0;
+
+    memset(len, 0, 256);
+    for (int i = 0; i < 256; i++) {
+        weight[i] = freq[i];
+        alive[i] = freq[i] > 0;
+        parent[i] = -1;
+        used += alive[i];
+    }
+    if (used == 1) {
+        for (int i = 0; i < 256; i++) {
+            if (freq[i]) {
+                len[i] = 1;
+            }
+        }
+        return;
+    }
+
+    // Repeatedly merge the two lightest live nodes
+    for (int merged = 1; merged < used; merged++) {
+        int a = -1;
+        int b = -1;
+        for (int i = 0; i < nodes; i++) {
+            if (!alive[i]) {
+                continue;
+            }
+            if (a < 0 || weight[i] < weight[a]) {
+                b = a;
+                a = i;
+            } else if (b < 0 || weight[i] < weight[b]) {
+                b = i;
+            }
+        }
+        weight[nodes] = weight[a] + weight[b];
+        alive[nodes] = 1;
+        parent[nodes] = -1;
+        alive[a] = alive[b] = 0;
+        parent[a] = parent[b] = nodes;
+        nodes++;
+    }
+
+    int kraft_over = 0;
+    for (int i = 0; i < 256; i++) {
+        if (!freq[i]) {
+            continue;
+        }
+        int depth = 0;
+        for (int p = parent[i]; p >= 0; p = parent[p]) {
+            depth++;
+        }
+        if (depth > HUF_MAX_BITS) {
+            depth = HUF_MAX_BITS;
+            kraft_over = 1;
+        }
+        len[i] = (uint8_t)depth;
+    }
+    if (!kraft_over) {
+        return;
+    }
+
+    // Clamping broke the Kraft inequality; lengthen the deepest codes that
+    // still have room until the code is complete again
+    uint64_t kraft = 0;
+    for (int i = 0; i < 256; i++) {
+        if (len[i]) {
+            kraft += 1ull << (HUF_MAX_BITS - len[i]);
+        }
+    }
+    while (kraft > HUF_TABLE_SIZE) {
+        int best = -1;
+        for (int i = 0; i < 256; i++) {
+            if (len[i] && len[i] < HUF_MAX_BITS && (best < 0 || len[i] > len[best] ||
+                (len[i] == len[best] && freq[i] < freq[best]))) {
+                best = i;
+            }
+        }
+        kraft -= 1ull << (HUF_MAX_BITS - len[best] - 1);
+        len[best]++;
+    }
+}
+
+// Assign canonical codes, bit-reversed because the stream is read LSB first
+static void huf_assign_codes(const uint8_t len[256], uint16_t code[256]) {
+    int count[HUF_MAX_BITS + 1] = {0};
+    int next[HUF_MAX_BITS + 1];
+
+    for (int i = 0; i < 256; i++) {
+        count[len[i]]++;
+    }
+    count[0] = 0;
+    int value = 0;
+    for (int bits = 1; bits <= HUF_MAX_BITS; bits++) {
+        value = (value + count[bits - 1]) << 1;
+        next[bits] = value;
+    }
+    for (int i = 0; i < 256; i++) {
+        if (!len[i]) {
+            continue;
+        }
+        int c = next[len[i]]++;
+        int reversed = 0;
+        for (int b = 0; b < len[i]; b++) {
+            reversed |= ((c >> b) & 1) << (len[i] - 1 - b);
+        }
+        code[i] = (uint16_t)reversed;
+    }
+}
+
+// Pick code lengths for in[0..n); returns an upper bound of the payload size
+static size_t huf_plan(const uint8_t *in, size_t n, uint8_t len[256]) {
+    uint64_t freq[256] = {0};
+    for (size_t i = 0; i < n; i++) {
+        freq[in[i]]++;
+    }
+    huf_build_lengths(freq, len);
+    uint64_t bits = 0;
+    for (int i = 0; i < 256; i++) {
+        bits += freq[i] * len[i];
+    }
+    return HUF_HEADER_SIZE + (size_t)(bits / 8) + HUF_STREAMS;
+}
+
+// Write one bitstream; returns its size in bytes
+static size_t huf_encode_stream(const uint8_t *in, size_t n, const uint8_t len[256], const uint16_t code[256], uint8_t *out) {
+    uint8_t *p = out;
+    uint64_t acc = 0;
+    int nbits = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        acc |= (uint64_t)code[in[i]] << nbits;
+        nbits += len[in[i]];
+        if (nbits >= 32) {
+            put_u32(p, (uint32_t)acc);
+            p += 4;
+            acc >>= 32;
+            nbits -= 32;
+        }
+    }
+    while (nbits > 0) {
+        *p++ = (uint8_t)acc;
+        acc >>= 8;
+        nbits -= 8;
+    }
+    return (size_t)(p - out);
+}
+
+// Huffman code in[0..n) with the lengths from huf_plan; returns the payload size
+static size_t huf_encode(const uint8_t *in, size_t n, const uint8_t len[256], uint8_t *out) {
+    uint16_t code[256];
+    size_t segment = (n + HUF_STREAMS - 1) / HUF_STREAMS;
+    uint8_t *p = out + HUF_HEADER_SIZE;
+
+    huf_assign_codes(len, code);
+    put_u32(out, (uint32_t)n);
+    for (int i = 0; i < 128; i++) {
+        out[4 + i] = (uint8_t)(len[2 * i] | (len[2 * i + 1] << 4));
+    }
+    for (int k = 0; k < HUF_STREAMS; k++) {
+        size_t start = segment * (size_t)k < n ? segment * (size_t)k : n;
+        size_t end = start + segment < n ? start + segment : n;
+        size_t size = huf_encode_stream(in + start, end - start, len, code, p);
+        if (k < HUF_STREAMS - 1) {
+            put_u32(out + 132 + 4 * k, (uint32_t)size);
+        }
+        p += size;
+    }
+    return (size_t)(p - out);
+}
+
+// Unaligned little endian 64 bit load for the hot decode loop
+static inline uint64_t load_u64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+// Read state of one bitstream
+typedef struct {
+    const uint8_t *bits;
+    size_t nbytes;
+    uint64_t bitpos;
+    uint8_t *out;
+    size_t count;
+} HufStream;
+
+// Up to 64 bits of s starting at its bit position (zero past the end)
+static inline uint64_t huf_peek(const HufStream *s) {
+    size_t byte = (size_t)(s->bitpos >> 3);
+    uint64_t window = 0;
+    if (byte + 8 <= s->nbytes) {
+        window = load_u64(s->bits + byte);
+    } else {
+        for (size_t b = 0; byte + b < s->nbytes; b++) {
+            window |= (uint64_t)s->bits[byte + b] << (8 * b);
+        }
+    }
+    return window >> (s->bitpos & 7);
+}
+
+// Decode a Huffman payload into out; returns the op stream size or a negative status
+static long huf_decode(const uint8_t *in, size_t n, uint8_t *out, size_t cap) {
+    HufEntry table[HUF_LOOKUP_SIZE];
+    uint16_t first[HUF_TABLE_SIZE];
+    HufStream st[HUF_STREAMS];
+    uint8_t len[256];
+    uint16_t code[256];
+
+    if (n < HUF_HEADER_SIZE) {
+        return RLE_ERR_CORRUPT;
+    }
+    size_t count = get_u32(in);
+    if (count > cap) {
+        return RLE_ERR_CORRUPT;
+    }
+    uint64_t kraft = 0;
+    for (int i = 0; i < 128; i++) {
+        len[2 * i] = in[4 + i] & 0x0F;
+        len[2 * i + 1] = in[4 + i] >> 4;
+    }
+    for (int i = 0; i < 256; i++) {
+        if (len[i] > HUF_MAX_BITS) {
+            return RLE_ERR_CORRUPT;
+        }
+        if (len[i]) {
+            kraft += 1ull << (HUF_MAX_BITS - len[i]);
+        }
+    }
+    if (kraft > HUF_TABLE_SIZE) {
+        return RLE_ERR_CORRUPT;
+    }
+
+    // Slots no code maps to only show up in corrupt input; they decode to a
+    // maximal length code so the stream overrun check below catches them
+    huf_assign_codes(len, code);
+    for (int c = 0; c < HUF_TABLE_SIZE; c++) {
+        first[c] = (uint16_t)(HUF_MAX_BITS << 8);
+    }
+    for (int i = 0; i < 256; i++) {
+        for (int c = code[i]; len[i] && c < HUF_TABLE_SIZE; c += 1 << len[i]) {
+            first[c] = (uint16_t)(i | (len[i] << 8));
+        }
+    }
+    for (int c = 0; c < HUF_LOOKUP_SIZE; c++) {
+        uint16_t head = first[c & (HUF_TABLE_SIZE - 1)];
+        uint32_t bits0 = head >> 8;
+        uint16_t next = first[(c >> bits0) & (HUF_TABLE_SIZE - 1)];
+        uint32_t bits1 = next >> 8;
+        table[c] = (head & 0xFFu) | (bits0 << 16) | (1u << 20) | (bits0 << 24);
+        if (bits0 + bits1 <= HUF_LOOKUP_BITS) {
+            table[c] = (head & 0xFFu) | (uint32_t)(next & 0xFF) << 8 | (bits0 + bits1) << 16 | (2u << 20) | (bits0 << 24);
+        }
+    }
+
+    size_t segment = (count + HUF_STREAMS - 1) / HUF_STREAMS;
+    const uint8_t *bits = in + HUF_HEADER_SIZE;
+    size_t left = n - HUF_HEADER_SIZE;
+    for (int k = 0; k < HUF_STREAMS; k++) {
+        size_t size = k < HUF_STREAMS - 1 ? get_u32(in + 132 + 4 * k) : left;
+        size_t start = segment * (size_t)k < count ? segment * (size_t)k : count;
+        if (size > left) {
+            return RLE_ERR_CORRUPT;
+        }
+        st[k].bits = bits;
+        st[k].nbytes = size;
+        st[k].bitpos = 0;
+        st[k].out = out + start;
+        st[k].count = (start + segment < count ? start + segment : count) - start;
+        bits += size;
+        left -= size;
+    }
+
+    // Fast path: one 64 bit load per stream yields at least 57 bits, enough
+    // for HUF_ROUND_LOOKUPS lookups of HUF_LOOKUP_BITS. Each pass first works out how many
+    // rounds every stream can take without reading past its bytes or
+    // writing past its output (a lookup always stores two bytes), so the
+    // four interleaved lookup chains run without bounds checks.
+    while (1) {
+        size_t rounds = SIZE_MAX;
+        for (int k = 0; k < HUF_STREAMS; k++) {
+            uint64_t readable = st[k].nbytes >= 8 ? 8 * (uint64_t)(st[k].nbytes - 8) : 0;
+            size_t by_bits = readable > st[k].bitpos ? (size_t)((readable - st[k].bitpos) / HUF_ROUND_BITS) : 0;
+            size_t by_out = st[k].count > 0 ? (st[k].count - 1) / HUF_ROUND_SYMBOLS : 0;
+            rounds = by_bits < rounds ? by_bits : rounds;
+            rounds = by_out < rounds ? by_out : rounds;
+        }
+        if (rounds < 4) {
+            break;
+        }
+        const uint8_t *p0 = st[0].bits, *p1 = st[1].bits, *p2 = st[2].bits, *p3 = st[3].bits;
+        uint8_t *o0 = st[0].out, *o1 = st[1].out, *o2 = st[2].out, *o3 = st[3].out;
+        uint64_t b0 = st[0].bitpos, b1 = st[1].bitpos, b2 = st[2].bitpos, b3 = st[3].bitpos;
+        for (size_t r = 0; r < rounds; r++) {
+            uint64_t w0 = load_u64(p0 + (b0 >> 3)) >> (b0 & 7);
+            uint64_t w1 = load_u64(p1 + (b1 >> 3)) >> (b1 & 7);
+            uint64_t w2 = load_u64(p2 + (b2 >> 3)) >> (b2 & 7);
+            uint64_t w3 = load_u64(p3 + (b3 >> 3)) >> (b3 & 7);
+            for (int i = 0; i < HUF_ROUND_LOOKUPS; i++) {
+                HufEntry e0 = table[w0 & (HUF_LOOKUP_SIZE - 1)];
+                HufEntry e1 = table[w1 & (HUF_LOOKUP_SIZE - 1)];
+                HufEntry e2 = table[w2 & (HUF_LOOKUP_SIZE - 1)];
+                HufEntry e3 = table[w3 & (HUF_LOOKUP_SIZE - 1)];
+                uint16_t s0 = (uint16_t)e0, s1 = (uint16_t)e1, s2 = (uint16_t)e2, s3 = (uint16_t)e3;
+                memcpy(o0, &s0, 2);
+                memcpy(o1, &s1, 2);
+                memcpy(o2, &s2, 2);
+                memcpy(o3, &s3, 2);
+                o0 += HUF_ENTRY_SYMBOLS(e0);
+                o1 += HUF_ENTRY_SYMBOLS(e1);
+                o2 += HUF_ENTRY_SYMBOLS(e2);
+                o3 += HUF_ENTRY_SYMBOLS(e3);
+                w0 >>= HUF_ENTRY_BITS(e0);
+                w1 >>= HUF_ENTRY_BITS(e1);
+                w2 >>= HUF_ENTRY_BITS(e2);
+                w3 >>= HUF_ENTRY_BITS(e3);
+                b0 += HUF_ENTRY_BITS(e0);
+                b1 += HUF_ENTRY_BITS(e1);
+                b2 += HUF_ENTRY_BITS(e2);
+                b3 += HUF_ENTRY_BITS(e3);
+            }
+        }
+        st[0].bitpos = b0;
+        st[1].bitpos = b1;
+        st[2].bitpos = b2;
+        st[3].bitpos = b3;
+        st[0].count -= (size_t)(o0 - st[0].out);
+        st[1].count -= (size_t)(o1 - st[1].out);
+        st[2].count -= (size_t)(o2 - st[2].out);
+        st[3].count -= (size_t)(o3 - st[3].out);
+        st[0].out = o0;
+        st[1].out = o1;
+        st[2].out = o2;
+        st[3].out = o3;
+    }
+    for (int k = 0; k < HUF_STREAMS; k++) {
+        while (st[k].count > 0) {
+            HufEntry e = table[huf_peek(&st[k]) & (HUF_LOOKUP_SIZE - 1)];
+            *st[k].out++ = (uint8_t)e;
+            st[k].bitpos += HUF_ENTRY_FIRST_BITS(e);
+            st[k].count--;
+        }
+        if ((st[k].bitpos + 7) / 8 > st[k].nbytes) {
+            return RLE_ERR_CORRUPT;
+        }
+    }
+    return (long)count;
+}
+
+// Adaptive block coding. A few slices of the block are coded first; if
+// neither RLE nor the Huffman stage shrinks them the block is stored raw
+// without coding the rest. Otherwise the whole block is RLE coded and the
+// smallest of raw, RLE and Huffman coded RLE is kept, Huffman only when
+// it saves at least 1/HUF_MIN_GAIN. Huffman decoding slows down
+// as codes get longer and drops below 1 GB/s at about 6.5 bits per op
+// byte, so streams that code only slightly smaller stay plain RLE.
+enum { RLE_METHOD_RAW, RLE_METHOD_RLE, RLE_METHOD_HUFFMAN };
+
+#define HUF_MIN_GAIN 4
+#define RLE_SAMPLE_SIZE 4096
+#define RLE_SAMPLE_COUNT 8
+
+// Code one block (header included) into out; scratch holds at least
+// rle_encode_bound(n) bytes. Returns the block size.
+static size_t rle_encode_block(const uint8_t *in, size_t n, uint8_t *out, uint8_t *scratch) {
+    uint8_t *payload = out + RLE_BLOCK_HEADER_SIZE;
+    uint8_t len[256];
+    int method = RLE_METHOD_RAW;
+    size_t size = n;
+
+    int worth_trying = 1;
+    if (n >= 4 * RLE_SAMPLE_COUNT * RLE_SAMPLE_SIZE) {
+        size_t sample_raw = RLE_SAMPLE_COUNT * RLE_SAMPLE_SIZE;
+        size_t sampled = 0;
+        for (int i = 0; i < RLE_SAMPLE_COUNT; i++) {
+            sampled += rle_encode(in + (n / RLE_SAMPLE_COUNT) * i, RLE_SAMPLE_SIZE, scratch + sampled);
+        }
+        worth_trying = sampled < sample_raw || huf_plan(scratch, sampled, len) < sample_raw - sample_raw / HUF_MIN_GAIN;
+    }
+    if (worth_trying) {
+        size_t ops = rle_encode(in, n, scratch);
+        size_t huf_size = huf_plan(scratch, ops, len);
+        if (huf_size < ops - ops / HUF_MIN_GAIN && huf_size < n) {
+            method = RLE_METHOD_HUFFMAN;
+            size = huf_encode(scratch, ops, len, payload);
+        } else if (ops < n) {
+            method = RLE_METHOD_RLE;
+            size = ops;
+            memcpy(payload, scratch, size);
+        }
+    }
+    if (method == RLE_METHOD_RAW) {
+        memcpy(payload, in, n);
+    }
+
+    out[0] = (uint8_t)method;
+    put_u32(out + 1, (uint32_t)n);
+    put_u32(out + 5, (uint32_t)size);
+    return RLE_BLOCK_HEADER_SIZE + size;
+}
+
+// Record (raw offset, op stream offset) of every interval-th op of
+// ops[0..n) into entries; returns the number of entries
+static size_t rle_index_runs(const uint8_t *ops, size_t n, uint32_t interval, uint8_t *entries) {
+    size_t pos = 0;
+    size_t raw = 0;
+    size_t count = 0;
+    for (size_t op = 0; pos < n; op++) {
+        int is_run;
+        const uint8_t *data;
+        size_t length;
+        long size = rle_parse_op(ops + pos, n - pos, &is_run, &data, &length);
+        if (size <= 0) {
+            break;
+        }
+        if (op % interval == 0) {
+            put_u32(entries + count * RLE_RUN_ENTRY_SIZE, (uint32_t)raw);
+            put_u32(entries + count * RLE_RUN_ENTRY_SIZE + 4, (uint32_t)pos);
+            count++;
+        }
+        raw += length;
+        pos += (size_t)size;
+    }
+    return count;
+}
+
+// Decode one block (header included) of raw_size bytes into out; scratch
+// holds at least rle_encode_bound(raw_size) bytes. Returns a status.
+static int rle_decode_block(const uint8_t *block, size_t n, uint8_t *out, size_t raw_size, uint8_t *scratch) {
+    if (n < RLE_BLOCK_HEADER_SIZE || get_u32(block + 1) != raw_size ||
+        get_u32(block + 5) != n - RLE_BLOCK_HEADER_SIZE) {
+        return RLE_ERR_CORRUPT;
+    }
+    const uint8_t *payload = block + RLE_BLOCK_HEADER_SIZE;
+    size_t size = n - RLE_BLOCK_HEADER_SIZE;
+    long decoded;
+
+    switch (block[0]) {
+        case RLE_METHOD_RAW:
+            if (size != raw_size) {
+                return RLE_ERR_CORRUPT;
+            }
+            memcpy(out, payload, size);
+            return RLE_OK;
+        case RLE_METHOD_RLE:
+            decoded = rle_decode(payload, size, out, raw_size);
+            break;
+        case RLE_METHOD_HUFFMAN:
+            decoded = huf_decode(payload, size, scratch, rle_encode_bound(raw_size));
+            if (decoded >= 0) {
+                decoded = rle_decode(scratch, (size_t)decoded, out, raw_size);
+            }
+            break;
+        default:
+            return RLE_ERR_CORRUPT;
+    }
+    return decoded == (long)raw_size ? RLE_OK : RLE_ERR_CORRUPT;
+}
+
+// Read the header and block index of a framed file opened on fd
+static int rle_load_frame(RleFile *file, int fd) {
+    uint8_t header[RLE_FRAME_HEADER_SIZE];
+    file->fd = fd;
+    file->index = NULL;
+    file->run_start = NULL;
+
+    if (pread(fd, header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+        memcmp(header, RLE_FRAME_MAGIC, RLE_MAGIC_SIZE) != 0) {
+        return RLE_ERR_FORMAT;
+    }
+    file->block_size = get_u32(header + 4);
+    file->block_count = get_u32(header + 8);
+    file->total_size = get_u64(header + 12);
+    uint64_t index_offset = get_u64(header + 20);
+    file->run_interval = get_u32(header + 28);
+    file->run_index_offset = get_u64(header + 32);
+    if (file->block_size == 0 || file->block_size > RLE_MAX_BLOCK_SIZE ||
+        file->total_size > (uint64_t)file->block_count * file->block_size) {
+        return RLE_ERR_CORRUPT;
+    }
+    // The index has to be inside the file before its size is trusted for
+    // an allocation
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return RLE_ERR_IO;
+    }
+    if (index_offset > (uint64_t)st.st_size ||
+        file->block_count > ((uint64_t)st.st_size - index_offset) / RLE_INDEX_ENTRY_SIZE) {
+        return RLE_ERR_CORRUPT;
+    }
+
+    size_t index_size = (size_t)file->block_count * RLE_INDEX_ENTRY_SIZE;
+    uint8_t *raw = malloc(index_size + 1);
+    file->index = malloc(((size_t)file->block_count + 1) * sizeof(RleBlockInfo));
+    if (!raw || !file->index) {
+        free(raw);
+        return RLE_ERR_NOMEM;
+    }
+    if (pread(fd, raw, index_size, (off_t)index_offset) != (ssize_t)index_size) {
+        free(raw);
+        return RLE_ERR_CORRUPT;
+    }
+    size_t coded_limit = RLE_BLOCK_HEADER_SIZE + rle_encode_bound(file->block_size);
+    uint64_t raw_total = 0;
+    for (uint32_t i = 0; i < file->block_count; i++) {
+        const uint8_t *entry = raw + (size_t)i * RLE_INDEX_ENTRY_SIZE;
+        file->index[i].offset = get_u64(entry);
+        file->index[i].coded_size = get_u32(entry + 8);
+        file->index[i].raw_size = get_u32(entry + 12);
+        if (file->index[i].coded_size < RLE_BLOCK_HEADER_SIZE || file->index[i].coded_size > coded_limit ||
+            file->index[i].raw_size > file->block_size ||
+            (i + 1 < file->block_count && file->index[i].raw_size != file->block_size)) {
+            free(raw);
+            return RLE_ERR_CORRUPT;
+        }
+        raw_total += file->index[i].raw_size;
+    }
+    free(raw);
+    // Decoders place block i at i * block_size and size it by the index, so
+    // the header's total must be exactly what the blocks add up to
+    if (raw_total != file->total_size) {
+        return RLE_ERR_CORRUPT;
+    }
+
+    if (file->run_interval > 0) {
+        size_t starts = (size_t)file->block_count + 1;
+        file->run_start = malloc(starts * sizeof(uint64_t));
+        raw = malloc(starts * sizeof(uint64_t));
+        if (!file->run_start || !raw) {
+            free(raw);
+            return RLE_ERR_NOMEM;
+        }
+        if (pread(fd, raw, starts * sizeof(uint64_t), (off_t)file->run_index_offset) != (ssize_t)(starts * sizeof(uint64_t))) {
+            free(raw);
+            return RLE_ERR_CORRUPT;
+        }
+        for (size_t i = 0; i < starts; i++) {
+            file->run_start[i] = get_u64(raw + i * sizeof(uint64_t));
+            if (i > 0 && file->run_start[i] < file->run_start[i - 1]) {
+                free(raw);
+                return RLE_ERR_CORRUPT;
+            }
+        }
+        free(raw);
+    }
+    return RLE_OK;
+}
+
+// Open a framed compressed file for random access; NULL on failure
+RleFile *rle_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    RleFile *file = malloc(sizeof(RleFile));
+    if (!file || rle_load_frame(file, fd) != RLE_OK) {
+        if (file) {
+            free(file->index);
+            free(file->run_start);
+        }
+        free(file);
+        close(fd);
+        return NULL;
+    }
+    return file;
+}
+
+// Close a file returned by rle_open
+void rle_close(RleFile *file) {
+    if (file) {
+        close(file->fd);
+        free(file->index);
+        free(file->run_start);
+        free(file);
+    }
+}
+
+// Decode block number `block` into out without touching any other block;
+// returns its raw size or a negative status
+long rle_read_block(RleFile *file, uint32_t block, uint8_t *out, size_t cap) {
+    if (block >= file->block_count) {
+        return RLE_ERR_ARG;
+    }
+    const RleBlockInfo *info = &file->index[block];
+    if (cap < info->raw_size) {
+        return RLE_ERR_ARG;
+    }
+    uint8_t *coded = malloc(info->coded_size);
+    uint8_t *scratch = malloc(rle_encode_bound(info->raw_size));
+    long result = RLE_ERR_NOMEM;
+    if (coded && scratch) {
+        result = RLE_ERR_CORRUPT;
+        if (pread(file->fd, coded, info->coded_size, (off_t)info->offset) == (ssize_t)info->coded_size &&
+            rle_decode_block(coded, info->coded_size, out, info->raw_size, scratch) == RLE_OK) {
+            result = (long)info->raw_size;
+        }
+    }
+    free(coded);
+    free(scratch);
+    return result;
+}
+
+// Expand the whole ops in buf[0..n), the first of which starts at raw
+// offset *raw, copying whatever overlaps [start, start + count) into out.
+// Updates *raw and *produced; returns the bytes of buf consumed, which
+// stops short at a truncated op or once the range is complete.
+static long rle_expand_range(const uint8_t *buf, size_t n, uint64_t *raw, uint64_t start, size_t count,
+                             uint8_t *out, size_t *produced) {
+    size_t pos = 0;
+    while (pos < n && *produced < count) {
+        int is_run;
+        const uint8_t *data;
+        size_t length;
+        long size = rle_parse_op(buf + pos, n - pos, &is_run, &data, &length);
+        if (size < 0) {
+            return RLE_ERR_CORRUPT;
+        }
+        if (size == 0) {
+            break;
+        }
+        uint64_t want = start + *produced;
+        if (*raw + length > want) {
+            size_t skip = (size_t)(want - *raw);
+            size_t take = length - skip;
+            if (take > count - *produced) {
+                take = count - *produced;
+            }
+            if (is_run) {
+                memset(out + *produced, *data, take);
+            } else {
+                memcpy(out + *produced, data + skip, take);
+            }
+            *produced += take;
+        }
+        *raw += length;
+        pos += (size_t)size;
+    }
+    return (long)pos;
+}
+
+// Find the last run index entry of a block at or before raw offset start;
+// sets the raw and op stream offsets to resume decoding from
+static int rle_seek_runs(RleFile *file, uint32_t block, uint64_t start, uint64_t *raw, uint64_t *op) {
+    *raw = 0;
+    *op = 0;
+    if (file->run_interval == 0) {
+        return RLE_OK;
+    }
+    uint64_t lo = file->run_start[block];
+    uint64_t hi = file->run_start[block + 1];
+    uint64_t base = file->run_index_offset + ((uint64_t)file->block_count + 1) * sizeof(uint64_t);
+    uint8_t entry[RLE_RUN_ENTRY_SIZE];
+
+    // Binary search for the last entry whose raw offset is <= start
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (pread(file->fd, entry, sizeof(entry), (off_t)(base + mid * RLE_RUN_ENTRY_SIZE)) != (ssize_t)sizeof(entry)) {
+            return RLE_ERR_CORRUPT;
+        }
+        if (get_u32(entry) <= start) {
+            *raw = get_u32(entry);
+            *op = get_u32(entry + 4);
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return RLE_OK;
+}
+
+// Read count bytes at offset start of one block, decoding only the ops
+// from the nearest run index entry up to the end of the range
+static long rle_read_block_range(RleFile *file, uint32_t block, uint64_t start, size_t count, uint8_t *out) {
+    const RleBlockInfo *info = &file->index[block];
+    uint64_t payload = info->offset + RLE_BLOCK_HEADER_SIZE;
+    size_t payload_size = info->coded_size - RLE_BLOCK_HEADER_SIZE;
+    uint8_t header[RLE_BLOCK_HEADER_SIZE];
+    uint64_t raw;
+    uint64_t op;
+
+    if (pread(file->fd, header, sizeof(header), (off_t)info->offset) != (ssize_t)sizeof(header)) {
+        return RLE_ERR_CORRUPT;
+    }
+    if (header[0] == RLE_METHOD_RAW) {
+        if (payload_size != info->raw_size || pread(file->fd, out, count, (off_t)(payload + start)) != (ssize_t)count) {
+            return RLE_ERR_CORRUPT;
+        }
+        return (long)count;
+    }
+    int status = rle_seek_runs(file, block, start, &raw, &op);
+    if (status != RLE_OK) {
+        return status;
+    }
+
+    size_t produced = 0;
+    if (header[0] == RLE_METHOD_HUFFMAN) {
+        // The bitstreams cannot be entered midway, but the decoded op stream
+        // can: expand only the ops from the run index entry onwards
+        uint8_t *coded = malloc(payload_size);
+        uint8_t *ops = malloc(rle_encode_bound(info->raw_size));
+        long n = RLE_ERR_NOMEM;
+        if (coded && ops) {
+            n = pread(file->fd, coded, payload_size, (off_t)payload) == (ssize_t)payload_size
+                ? huf_decode(coded, payload_size, ops, rle_encode_bound(info->raw_size)) : RLE_ERR_CORRUPT;
+        }
+        if (n >= 0) {
+            n = op <= (uint64_t)n ? rle_expand_range(ops + op, (size_t)n - op, &raw, start, count, out, &produced)
+                                  : RLE_ERR_CORRUPT;
+        }
+        free(coded);
+        free(ops);
+        if (n < 0) {
+            return n;
+        }
+    } else if (header[0] == RLE_METHOD_RLE) {
+        // Stream the op stream through a small window from the entry on
+        uint8_t window[1 << 16];
+        while (produced < count && op < payload_size) {
+            size_t want = payload_size - op < sizeof(window) ? payload_size - op : sizeof(window);
+            if (pread(file->fd, window, want, (off_t)(payload + op)) != (ssize_t)want) {
+                return RLE_ERR_CORRUPT;
+            }
+            long used = rle_expand_range(window, want, &raw, start, count, out, &produced);
+            if (used <= 0) {
+                return RLE_ERR_CORRUPT;
+            }
+            op += (uint64_t)used;
+        }
+    } else {
+        return RLE_ERR_CORRUPT;
+    }
+    return produced == count ? (long)count : RLE_ERR_CORRUPT;
+}
+
+// Read len bytes at uncompressed offset `offset` into out without decoding
+// anything outside the blocks and runs that cover the range. Returns the
+// number of bytes read (short at end of file) or a negative status.
+long rle_read_range(RleFile *file, uint64_t offset, size_t len, uint8_t *out) {
+    if (offset >= file->total_size) {
+        return 0;
+    }
+    if (len > file->total_size - offset) {
+        len = (size_t)(file->total_size - offset);
+    }
+    size_t done = 0;
+    while (done < len) {
+        uint64_t pos = offset + done;
+        uint32_t block = (uint32_t)(pos / file->block_size);
+        uint64_t start = pos % file->block_size;
+        size_t count = file->index[block].raw_size - start;
+        if (count > len - done) {
+            count = len - done;
+        }
+        long n = rle_read_block_range(file, block, start, count, out + done);
+        if (n < 0) {
+            return n;
+        }
+        done += count;
+    }
+    return (long)done;
+}
+
+// Compressed-domain queries. An RleScan walks decoded content as a series
+// of segments (a run of one byte or a stretch of literal bytes) straight
+// from the ops, so runs are never expanded and the work is O(ops) rather
+// than O(bytes). The same walk covers an op stream in memory, a plain
+// stream file and a framed file (raw blocks show up as one literal).
+typedef struct {
+    const uint8_t *in;
+    size_t n;
+    size_t pos;
+    int raw;                // in holds raw bytes rather than ops
+    int is_run;             // current segment
+    const uint8_t *data;
+    uint64_t left;
+    RleFile *file;          // framed input, walked block by block
+    uint32_t block;
+    uint8_t *coded;
+    uint8_t *ops;
+    uint8_t *map;           // mapping of a plain stream file
+    size_t map_size;
+} RleScan;
+
+// Walk an op stream held in memory
+static void rle_scan_memory(RleScan *s, const uint8_t *in, size_t n) {
+    memset(s, 0, sizeof(*s));
+    s->in = in;
+    s->n = n;
+}
+
+// Walk a plain or framed file
+static int rle_scan_open(RleScan *s, const char *path) {
+    uint8_t magic[RLE_MAGIC_SIZE];
+    struct stat st;
+
+    memset(s, 0, sizeof(*s));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return RLE_ERR_IO;
+    }
+    if (read_full(fd, magic, RLE_MAGIC_SIZE) != RLE_MAGIC_SIZE || fstat(fd, &st) != 0) {
+        close(fd);
+        return RLE_ERR_FORMAT;
+    }
+    if (memcmp(magic, RLE_FRAME_MAGIC, RLE_MAGIC_SIZE) == 0) {
+        close(fd);
+        s->file = rle_open(path);
+        return s->file ? RLE_OK : RLE_ERR_FORMAT;
+    }
+    if (memcmp(magic, RLE_MAGIC, RLE_MAGIC_SIZE) != 0) {
+        close(fd);
+        return RLE_ERR_FORMAT;
+    }
+    s->map_size = (size_t)st.st_size;
+    if (s->map_size > RLE_MAGIC_SIZE) {
+        s->map = mmap(NULL, s->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (s->map == MAP_FAILED) {
+            s->map = NULL;
+            close(fd);
+            return RLE_ERR_IO;
+        }
+        madvise(s->map, s->map_size, MADV_SEQUENTIAL);
+        s->in = s->map + RLE_MAGIC_SIZE;
+        s->n = s->map_size - RLE_MAGIC_SIZE;
+    }
+    close(fd);
+    return RLE_OK;
+}
+
+// Release what rle_scan_open set up
+static void rle_scan_close(RleScan *s) {
+    if (s->map) {
+        munmap(s->map, s->map_size);
+    }
+    free(s->coded);
+    free(s->ops);
+    rle_close(s->file);
+    memset(s, 0, sizeof(*s));
+}
+
+// Point the scan at the payload of the next framed block
+static int rle_scan_load_block(RleScan *s) {
+    const RleBlockInfo *info = &s->file->index[s->block++];
+    size_t bound = rle_encode_bound(info->raw_size);
+
+    free(s->coded);
+    free(s->ops);
+    s->coded = malloc(info->coded_size);
+    s->ops = NULL;
+    if (!s->coded) {
+        return RLE_ERR_NOMEM;
+    }
+    if (info->coded_size < RLE_BLOCK_HEADER_SIZE ||
+        pread(s->file->fd, s->coded, info->coded_size, (off_t)info->offset) != (ssize_t)info->coded_size) {
+        return RLE_ERR_CORRUPT;
+    }
+    s->in = s->coded + RLE_BLOCK_HEADER_SIZE;
+    s->n = info->coded_size - RLE_BLOCK_HEADER_SIZE;
+    s->pos = 0;
+    s->raw = 0;
+    switch (s->coded[0]) {
+        case RLE_METHOD_RAW:
+            s->raw = 1;
+            return s->n == info->raw_size ? RLE_OK : RLE_ERR_CORRUPT;
+        case RLE_METHOD_RLE:
+            return RLE_OK;
+        case RLE_METHOD_HUFFMAN: {
+            // Huffman only hides the ops; undo it and walk the ops as usual
+            s->ops = malloc(bound);
+            long n = s->ops ? huf_decode(s->in, s->n, s->ops, bound) : RLE_ERR_NOMEM;
+            if (n < 0) {
+                return n == RLE_ERR_NOMEM ? RLE_ERR_NOMEM : RLE_ERR_CORRUPT;
+            }
+            s->in = s->ops;
+            s->n = (size_t)n;
+            return RLE_OK;
+        }
+    }
+    return RLE_ERR_CORRUPT;
+}
+
+// Largest content length the queries report; corrupt varints can claim more
+#define RLE_SCAN_MAX ((uint64_t)1 << 62)
+
+// Advance to the next segment; returns 1, 0 at the end or a negative status
+static int rle_scan_next(RleScan *s) {
+    while (s->pos == s->n) {
+        if (!s->file || s->block == s->file->block_count) {
+            return 0;
+        }
+        int status = rle_scan_load_block(s);
+        if (status != RLE_OK) {
+            return status;
+        }
+    }
+    if (s->raw) {
+        s->is_run = 0;
+        s->data = s->in;
+        s->left = s->n;
+        s->pos = s->n;
+        return 1;
+    }
+    size_t count;
+    long size = rle_parse_op(s->in + s->pos, s->n - s->pos, &s->is_run, &s->data, &count);
+    if (size <= 0 || count > RLE_SCAN_MAX) {
+        return RLE_ERR_CORRUPT;
+    }
+    s->left = count;
+    s->pos += (size_t)size;
+    return 1;
+}
+
+// Add the byte counts of the scanned content to hist; returns the content
+// length or a negative status
+static long long rle_scan_histogram(RleScan *s, uint64_t hist[256]) {
+    long long total = 0;
+    int more;
+
+    while ((more = rle_scan_next(s)) > 0) {
+        if (s->is_run) {
+            hist[*s->data] += s->left;
+        } else {
+            for (uint64_t i = 0; i < s->left; i++) {
+                hist[s->data[i]]++;
+            }
+        }
+        total += (long long)s->left;
+        if ((uint64_t)total > RLE_SCAN_MAX) {
+            return RLE_ERR_CORRUPT;
+        }
+    }
+    return more < 0 ? more : total;
+}
+
+// Offset of the first byte equal to value, -1 if there is none, or
+// RLE_ERR_CORRUPT
+static long long rle_scan_find(RleScan *s, uint8_t value) {
+    long long offset = 0;
+    int more;
+
+    while ((more = rle_scan_next(s)) > 0) {
+        if (s->is_run) {
+            if (*s->data == value) {
+                return offset;
+            }
+        } else {
+            const uint8_t *hit = memchr(s->data, value, s->left);
+            if (hit) {
+                return offset + (hit - s->data);
+            }
+        }
+        offset += (long long)s->left;
+        if ((uint64_t)offset > RLE_SCAN_MAX) {
+            return RLE_ERR_CORRUPT;
+        }
+    }
+    return more < 0 ? more : -1;
+}
+
+// Compare the content of two scans segment by segment; returns 1 if they
+// are equal, 0 if not or a negative status
+static int rle_scan_equal(RleScan *a, RleScan *b) {
+    a->left = 0;
+    b->left = 0;
+    while (1) {
+        int more_a = a->left ? 1 : rle_scan_next(a);
+        int more_b = b->left ? 1 : rle_scan_next(b);
+        if (more_a < 0 || more_b < 0) {
+            return more_a < 0 ? more_a : more_b;
+        }
+        if (!more_a || !more_b) {
+            return more_a == more_b;
+        }
+        uint64_t m = a->left < b->left ? a->left : b->left;
+        if (a->is_run && b->is_run) {
+            if (*a->data != *b->data) {
+                return 0;
+            }
+        } else if (a->is_run || b->is_run) {
+            const RleScan *run = a->is_run ? a : b;
+            const uint8_t *bytes = a->is_run ? b->data : a->data;
+            for (uint64_t i = 0; i < m; i++) {
+                if (bytes[i] != *run->data) {
+                    return 0;
+                }
+            }
+        } else if (memcmp(a->data, b->data, m) != 0) {
+            return 0;
+        }
+        a->left -= m;
+        b->left -= m;
+        if (!a->is_run) {
+            a->data += m;
+        }
+        if (!b->is_run) {
+            b->data += m;
+        }
+    }
+}
+
+// Decoded length of an op stream, or RLE_ERR_CORRUPT
+long long rle_ops_length(const uint8_t *in, size_t n) {
+    RleScan s;
+    long long total = 0;
+    int more;
+
+    rle_scan_memory(&s, in, n);
+    while ((more = rle_scan_next(&s)) > 0) {
+        total += (long long)s.left;
+        if ((uint64_t)total > RLE_SCAN_MAX) {
+            return RLE_ERR_CORRUPT;
+        }
+    }
+    return more < 0 ? more : total;
+}
+
+// Add the decoded byte counts of an op stream to hist; returns the decoded
+// length or RLE_ERR_CORRUPT
+long long rle_ops_histogram(const uint8_t *in, size_t n, uint64_t hist[256]) {
+    RleScan s;
+    rle_scan_memory(&s, in, n);
+    return rle_scan_histogram(&s, hist);
+}
+
+// Decoded offset of the first byte equal to value in an op stream, -1 if
+// there is none, or RLE_ERR_CORRUPT
+long long rle_ops_find(const uint8_t *in, size_t n, uint8_t value) {
+    RleScan s;
+    rle_scan_memory(&s, in, n);
+    return rle_scan_find(&s, value);
+}
+
+// 1 if two op streams decode to the same bytes, 0 if not, or
+// RLE_ERR_CORRUPT; the streams may split their runs and literals differently
+int rle_ops_equal(const uint8_t *a, size_t na, const uint8_t *b, size_t nb) {
+    RleScan sa;
+    RleScan sb;
+    rle_scan_memory(&sa, a, na);
+    rle_scan_memory(&sb, b, nb);
+    return rle_scan_equal(&sa, &sb);
+}
+
+// Output size that always suffices for rle_ops_concat: merging the seam
+// can turn a short run op into a long one with a varint count
+size_t rle_concat_bound(size_t na, size_t nb) {
+    return na + nb + 16;
+}
 
-// Compress the input file and write to output file
-void compress(const char *input, const char *output) {
-    FILE *in = fopen(input, "r");
-    FILE *out = fopen(output, "w");
+// Concatenate two op streams into out (rle_concat_bound bytes). Only the
+// last op of a and the first op of b are rewritten: runs of the same byte
+// are merged, bytes next to a run that repeat its value join it, and two
+// literals are re-encoded together. Returns the size or RLE_ERR_CORRUPT.
+long rle_ops_concat(const uint8_t *a, size_t na, const uint8_t *b, size_t nb, uint8_t *out) {
+    size_t pos = 0;
+    size_t last = 0;
+    int left_run = 0, right_run = 0;
+    const uint8_t *left = NULL, *right = NULL;
+    size_t left_count = 0, right_count = 0;
+    long size = 0;
 
-    if (!in || !out) {
-        printf("File error.\n");
+    // a has to be walked to find its last op
+    while (pos < na) {
+        last = pos;
+        size = rle_parse_op(a + pos, na - pos, &left_run, &left, &left_count);
+        if (size <= 0) {
+            return RLE_ERR_CORRUPT;
+        }
+        pos += (size_t)size;
+    }
+    long first = nb ? rle_parse_op(b, nb, &right_run, &right, &right_count) : 0;
+    if (first < 0 || (nb && first == 0) || left_count > RLE_SCAN_MAX || right_count > RLE_SCAN_MAX) {
+        return RLE_ERR_CORRUPT;
+    }
+    if (na == 0 || nb == 0) {
+        memcpy(out, a, na);
+        memcpy(out + na, b, nb);
+        return (long)(na + nb);
+    }
+
+    uint8_t *p = out;
+    memcpy(p, a, last);
+    p += last;
+
+    // Pull repeated bytes at the seam into the neighbouring run
+    if (!left_run && right_run) {
+        while (left_count > 0 && left[left_count - 1] == *right) {
+            left_count--;
+            right_count++;
+        }
+    } else if (left_run && !right_run) {
+        while (right_count > 0 && *right == *left) {
+            right++;
+            right_count--;
+            left_count++;
+        }
+    }
+
+    if (left_run && right_run && *left == *right) {
+        p = rle_put_run(p, *left, left_count + right_count);
+    } else if (!left_run && !right_run) {
+        // At most two literal ops: re-encode them as one piece so a run
+        // spanning the seam is found and the chunks are refilled
+        uint8_t seam[2 * RLE_MAX_LITERAL];
+        memcpy(seam, left, left_count);
+        memcpy(seam + left_count, right, right_count);
+        p += rle_encode(seam, left_count + right_count, p);
+    } else {
+        p = left_run ? rle_put_run(p, *left, left_count) : rle_put_literals(p, left, left_count);
+        p = right_run ? rle_put_run(p, *right, right_count) : rle_put_literals(p, right, right_count);
+    }
+
+    memcpy(p, b + first, nb - (size_t)first);
+    p += nb - (size_t)first;
+    return (long)(p - out);
+}
+
+#ifndef RLE_FUZZ
+// Print the length and byte histogram of a plain or framed file
+static int rle_print_histogram(const char *path) {
+    uint64_t hist[256] = {0};
+    RleScan s;
+    int status = rle_scan_open(&s, path);
+    long long total = status == RLE_OK ? rle_scan_histogram(&s, hist) : status;
+
+    rle_scan_close(&s);
+    if (total < 0) {
+        return rle_report((int)total, NULL);
+    }
+    printf("length %lld\n", total);
+    for (int i = 0; i < 256; i++) {
+        if (hist[i]) {
+            printf("0x%02x %llu\n", i, (unsigned long long)hist[i]);
+        }
+    }
+    return RLE_OK;
+}
+
+// Print the offset of the first occurrence of a byte in a file
+static int rle_print_find(const char *path, uint8_t value) {
+    RleScan s;
+    int status = rle_scan_open(&s, path);
+    long long offset = status == RLE_OK ? rle_scan_find(&s, value) : status;
+
+    rle_scan_close(&s);
+    if (offset < -1) {
+        return rle_report((int)offset, NULL);
+    }
+    if (offset == -1) {
+        printf("byte 0x%02x not found\n", value);
+    } else {
+        printf("%lld\n", offset);
+    }
+    return RLE_OK;
+}
+
+// Tell whether two compressed files hold the same content
+static int rle_print_equal(const char *path_a, const char *path_b) {
+    RleScan a;
+    RleScan b;
+    int status = rle_scan_open(&a, path_a);
+    int equal = status;
+
+    if (status == RLE_OK) {
+        status = rle_scan_open(&b, path_b);
+        equal = status == RLE_OK ? rle_scan_equal(&a, &b) : status;
+        rle_scan_close(&b);
+    }
+    rle_scan_close(&a);
+    if (equal < 0) {
+        return rle_report(equal, NULL);
+    }
+    printf("%s\n", equal ? "equal" : "different");
+    return equal ? RLE_OK : 1;
+}
+
+// Join two plain stream files into a third without decoding them
+static int rle_join(const char *path_a, const char *path_b, const char *output) {
+    RleScan a;
+    RleScan b;
+    int status = rle_scan_open(&a, path_a);
+    uint8_t *out = NULL;
+
+    if (status == RLE_OK) {
+        status = rle_scan_open(&b, path_b);
+        if (status == RLE_OK && (a.file || b.file)) {
+            // Framed blocks all hold block_size bytes, so they cannot simply be appended
+            printf("Joining needs plain streams (compress with -c and no files).\n");
+            rle_scan_close(&b);
+            rle_scan_close(&a);
+            return RLE_ERR_FORMAT;
+        }
+        if (status == RLE_OK) {
+            out = malloc(RLE_MAGIC_SIZE + rle_concat_bound(a.n, b.n));
+            long n = out ? rle_ops_concat(a.in, a.n, b.in, b.n, out + RLE_MAGIC_SIZE) : RLE_ERR_NOMEM;
+            int fd = n >= 0 ? open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644) : -1;
+            if (n < 0) {
+                status = (int)n;
+            } else if (fd < 0) {
+                status = RLE_ERR_IO;
+            } else {
+                memcpy(out, RLE_MAGIC, RLE_MAGIC_SIZE);
+                if (write_full(fd, out, RLE_MAGIC_SIZE + (size_t)n) < 0) {
+                    status = RLE_ERR_IO;
+                }
+                close(fd);
+            }
+        }
+        rle_scan_close(&b);
+    }
+    rle_scan_close(&a);
+    free(out);
+    return rle_report(status, "Files joined successfully.");
+}
+
+#endif
+
+// Worker pool. The calling thread reads blocks into a ring of slots, the
+// workers code them, and the caller drains the slots strictly in block
+// order, so the ring doubles as the reorder buffer for the output.
+enum { SLOT_EMPTY, SLOT_READY, SLOT_DONE };
+
+// One block in flight
+typedef struct {
+    uint8_t *in;
+    size_t in_size;
+    uint8_t *out;
+    size_t out_size;
+    uint8_t *scratch;
+    size_t raw_size;
+    uint8_t *runs;
+    size_t run_count;
+    int state;
+    int status;
+} RleSlot;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_cond_t done;
+    RleSlot *slots;
+    size_t slot_count;
+    uint64_t queued;
+    uint64_t taken;
+    int stop;
+    int decode;
+    uint32_t run_interval;
+} RlePool;
+
+// Callbacks of rle_run_pool: fill returns 1 when it loaded a block into
+// the slot, 0 at end of input or a negative status; drain consumes the
+// coded result of block seq
+typedef int (*RleFillFn)(void *ctx, RleSlot *slot, uint64_t seq);
+typedef int (*RleDrainFn)(void *ctx, RleSlot *slot, uint64_t seq);
+
+// Compress or decompress a single slot; compressed non-raw blocks also get
+// their run index entries when run_interval is set
+static void rle_code_slot(RleSlot *slot, int decode, uint32_t run_interval) {
+    slot->status = RLE_OK;
+    if (!decode) {
+        slot->out_size = rle_encode_block(slot->in, slot->in_size, slot->out, slot->scratch);
+        slot->run_count = 0;
+        if (run_interval > 0 && slot->out[0] != RLE_METHOD_RAW) {
+            // The op stream of the block is still in scratch; its size is the
+            // payload size, or the first field of a Huffman payload
+            size_t ops = slot->out[0] == RLE_METHOD_RLE ? get_u32(slot->out + 5)
+                                                        : get_u32(slot->out + RLE_BLOCK_HEADER_SIZE);
+            slot->run_count = rle_index_runs(slot->scratch, ops, run_interval, slot->runs);
+        }
         return;
     }
+    slot->status = rle_decode_block(slot->in, slot->in_size, slot->out, slot->raw_size, slot->scratch);
+    slot->out_size = slot->raw_size;
+}
 
-    char current, previous;
-    int count = 1;
+static void *rle_worker(void *arg) {
+    RlePool *pool = arg;
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (!pool->stop && pool->taken == pool->queued) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+        }
+        if (pool->taken == pool->queued) {
+            break;
+        }
+        RleSlot *slot = &pool->slots[pool->taken++ % pool->slot_count];
+        pthread_mutex_unlock(&pool->lock);
 
-    previous = fgetc(in);
-    while ((current = fgetc(in)) != EOF) {
-        if (current == previous) {
-            count++;
+        rle_code_slot(slot, pool->decode, pool->run_interval);
+
+        pthread_mutex_lock(&pool->lock);
+        slot->state = SLOT_DONE;
+        pthread_cond_broadcast(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// Run every block of the input through `threads` workers
+static int rle_run_pool(int threads, int decode, size_t in_cap, size_t out_cap, size_t scratch_cap,
+                        uint32_t run_interval, RleFillFn fill, RleDrainFn drain, void *ctx) {
+    RlePool pool;
+    pthread_t *workers = calloc((size_t)threads, sizeof(pthread_t));
+    int started = 0;
+    int status = RLE_OK;
+
+    memset(&pool, 0, sizeof(pool));
+    pool.decode = decode;
+    pool.run_interval = run_interval;
+    pool.slot_count = (size_t)threads * 2;
+    pool.slots = calloc(pool.slot_count, sizeof(RleSlot));
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.work, NULL);
+    pthread_cond_init(&pool.done, NULL);
+    if (!workers || !pool.slots) {
+        status = RLE_ERR_NOMEM;
+        goto done;
+    }
+    for (size_t i = 0; i < pool.slot_count; i++) {
+        pool.slots[i].in = malloc(in_cap);
+        pool.slots[i].out = malloc(out_cap);
+        pool.slots[i].scratch = malloc(scratch_cap);
+        if (run_interval > 0) {
+            // An op takes at least two bytes of the op stream in scratch
+            pool.slots[i].runs = malloc((scratch_cap / 2 / run_interval + 2) * RLE_RUN_ENTRY_SIZE);
+        }
+        if (!pool.slots[i].in || !pool.slots[i].out || !pool.slots[i].scratch ||
+            (run_interval > 0 && !pool.slots[i].runs)) {
+            status = RLE_ERR_NOMEM;
+            goto done;
+        }
+    }
+    for (; started < threads; started++) {
+        if (pthread_create(&workers[started], NULL, rle_worker, &pool) != 0) {
+            break;
+        }
+    }
+    if (started == 0) {
+        status = RLE_ERR_NOMEM;
+        goto done;
+    }
+
+    uint64_t read_seq = 0;
+    uint64_t write_seq = 0;
+    int eof = 0;
+    while (status == RLE_OK) {
+        while (!eof && read_seq < write_seq + pool.slot_count) {
+            RleSlot *slot = &pool.slots[read_seq % pool.slot_count];
+            int filled = fill(ctx, slot, read_seq);
+            if (filled <= 0) {
+                status = filled;
+                eof = 1;
+                break;
+            }
+            pthread_mutex_lock(&pool.lock);
+            slot->state = SLOT_READY;
+            pool.queued = ++read_seq;
+            pthread_cond_signal(&pool.work);
+            pthread_mutex_unlock(&pool.lock);
+        }
+        if (write_seq == read_seq) {
+            break;
+        }
+
+        RleSlot *slot = &pool.slots[write_seq % pool.slot_count];
+        pthread_mutex_lock(&pool.lock);
+        while (slot->state != SLOT_DONE) {
+            pthread_cond_wait(&pool.done, &pool.lock);
+        }
+        pthread_mutex_unlock(&pool.lock);
+        if (status == RLE_OK) {
+            status = slot->status != RLE_OK ? slot->status : drain(ctx, slot, write_seq);
+        }
+        slot->state = SLOT_EMPTY;
+        write_seq++;
+    }
+
+done:
+    pthread_mutex_lock(&pool.lock);
+    pool.stop = 1;
+    pthread_cond_broadcast(&pool.work);
+    pthread_mutex_unlock(&pool.lock);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    if (pool.slots) {
+        for (size_t i = 0; i < pool.slot_count; i++) {
+            free(pool.slots[i].in);
+            free(pool.slots[i].out);
+            free(pool.slots[i].scratch);
+            free(pool.slots[i].runs);
+        }
+    }
+    free(pool.slots);
+    free(workers);
+    pthread_mutex_destroy(&pool.lock);
+    pthread_cond_destroy(&pool.work);
+    pthread_cond_destroy(&pool.done);
+    return status;
+}
+
+// State of a framed compression
+typedef struct {
+    int in;
+    int out;
+    size_t block_size;
+    uint64_t offset;
+    uint64_t total_size;
+    uint8_t *index;
+    size_t index_cap;
+    uint32_t block_count;
+    uint32_t run_interval;
+    uint8_t *runs;
+    size_t run_count;
+    size_t run_cap;
+    uint64_t *run_start;
+} RleCompressJob;
+
+static int rle_compress_fill(void *ctx, RleSlot *slot, uint64_t seq) {
+    RleCompressJob *job = ctx;
+    (void)seq;
+    ssize_t n = read_full(job->in, slot->in, job->block_size);
+    if (n < 0) {
+        return RLE_ERR_IO;
+    }
+    slot->in_size = (size_t)n;
+    return n > 0;
+}
+
+static int rle_compress_drain(void *ctx, RleSlot *slot, uint64_t seq) {
+    RleCompressJob *job = ctx;
+    (void)seq;
+
+    if ((size_t)(job->block_count + 1) * RLE_INDEX_ENTRY_SIZE > job->index_cap) {
+        size_t cap = job->index_cap ? job->index_cap * 2 : 64 * RLE_INDEX_ENTRY_SIZE;
+        uint8_t *index = realloc(job->index, cap);
+        uint64_t *run_start = realloc(job->run_start, (cap / RLE_INDEX_ENTRY_SIZE + 1) * sizeof(uint64_t));
+        if (index) {
+            job->index = index;
+        }
+        if (run_start) {
+            job->run_start = run_start;
+        }
+        if (!index || !run_start) {
+            return RLE_ERR_NOMEM;
+        }
+        job->index_cap = cap;
+    }
+    job->run_start[job->block_count] = job->run_count;
+    if (slot->run_count > 0) {
+        if ((job->run_count + slot->run_count) * RLE_RUN_ENTRY_SIZE > job->run_cap) {
+            size_t cap = (job->run_count + slot->run_count) * RLE_RUN_ENTRY_SIZE * 2;
+            uint8_t *runs = realloc(job->runs, cap);
+            if (!runs) {
+                return RLE_ERR_NOMEM;
+            }
+            job->runs = runs;
+            job->run_cap = cap;
+        }
+        memcpy(job->runs + job->run_count * RLE_RUN_ENTRY_SIZE, slot->runs, slot->run_count * RLE_RUN_ENTRY_SIZE);
+        job->run_count += slot->run_count;
+    }
+    uint8_t *entry = job->index + (size_t)job->block_count * RLE_INDEX_ENTRY_SIZE;
+    put_u64(entry, job->offset);
+    put_u32(entry + 8, (uint32_t)slot->out_size);
+    put_u32(entry + 12, (uint32_t)slot->in_size);
+
+    if (write_full(job->out, slot->out, slot->out_size) < 0) {
+        return RLE_ERR_IO;
+    }
+    job->offset += slot->out_size;
+    job->total_size += slot->in_size;
+    job->block_count++;
+    return RLE_OK;
+}
+
+// Write the run index section: per block start entries, then the entries
+static int rle_write_run_index(RleCompressJob *job) {
+    uint8_t start[sizeof(uint64_t)];
+    job->run_start[job->block_count] = job->run_count;
+    for (uint32_t i = 0; i <= job->block_count; i++) {
+        put_u64(start, job->run_start[i]);
+        if (write_full(job->out, start, sizeof(start)) < 0) {
+            return RLE_ERR_IO;
+        }
+    }
+    return write_full(job->out, job->runs, job->run_count * RLE_RUN_ENTRY_SIZE) < 0 ? RLE_ERR_IO : RLE_OK;
+}
+
+// Compress the input file into a framed file using `threads` workers; a
+// run_interval above zero adds a run index entry every run_interval ops
+int compress(const char *input, const char *output, int threads, size_t block_size, uint32_t run_interval) {
+    RleCompressJob job;
+    uint8_t header[RLE_FRAME_HEADER_SIZE];
+    int status = RLE_OK;
+
+    memset(&job, 0, sizeof(job));
+    job.in = open(input, O_RDONLY);
+    job.out = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    job.block_size = block_size;
+    job.offset = RLE_FRAME_HEADER_SIZE;
+    job.run_interval = run_interval;
+    job.run_start = malloc(sizeof(uint64_t));
+    if (job.in < 0 || job.out < 0 || !job.run_start) {
+        status = job.run_start ? RLE_ERR_IO : RLE_ERR_NOMEM;
+        goto done;
+    }
+
+    rle_init_kernels();
+
+    // The header is rewritten with the final counts once every block is out
+    memset(header, 0, sizeof(header));
+    if (write_full(job.out, header, sizeof(header)) < 0) {
+        status = RLE_ERR_IO;
+        goto done;
+    }
+    status = rle_run_pool(threads, 0, block_size, RLE_BLOCK_HEADER_SIZE + rle_encode_bound(block_size),
+                          rle_encode_bound(block_size), run_interval,
+                          rle_compress_fill, rle_compress_drain, &job);
+    if (status != RLE_OK) {
+        goto done;
+    }
+
+    memcpy(header, RLE_FRAME_MAGIC, RLE_MAGIC_SIZE);
+    put_u32(header + 4, (uint32_t)block_size);
+    put_u32(header + 8, job.block_count);
+    put_u64(header + 12, job.total_size);
+    put_u64(header + 20, job.offset);
+    put_u32(header + 28, run_interval);
+    put_u64(header + 32, job.offset + (uint64_t)job.block_count * RLE_INDEX_ENTRY_SIZE);
+    if (write_full(job.out, job.index, (size_t)job.block_count * RLE_INDEX_ENTRY_SIZE) < 0 ||
+        (run_interval > 0 && rle_write_run_index(&job) != RLE_OK) ||
+        pwrite(job.out, header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+        status = RLE_ERR_IO;
+    }
+
+done:
+    if (job.in >= 0) close(job.in);
+    if (job.out >= 0) close(job.out);
+    free(job.index);
+    free(job.runs);
+    free(job.run_start);
+    return rle_report(status, "File compressed successfully.");
+}
+
+// State of a framed decompression
+typedef struct {
+    RleFile file;
+    int out;
+} RleDecompressJob;
+
+static int rle_decompress_fill(void *ctx, RleSlot *slot, uint64_t seq) {
+    RleDecompressJob *job = ctx;
+    if (seq >= job->file.block_count) {
+        return 0;
+    }
+    const RleBlockInfo *info = &job->file.index[seq];
+    if (pread(job->file.fd, slot->in, info->coded_size, (off_t)info->offset) != (ssize_t)info->coded_size) {
+        return RLE_ERR_CORRUPT;
+    }
+    slot->in_size = info->coded_size;
+    slot->raw_size = info->raw_size;
+    return 1;
+}
+
+static int rle_decompress_drain(void *ctx, RleSlot *slot, uint64_t seq) {
+    RleDecompressJob *job = ctx;
+    (void)seq;
+    return write_full(job->out, slot->out, slot->out_size) < 0 ? RLE_ERR_IO : RLE_OK;
+}
+
+// Run fn(ctx, block, scratch) for every block in [0, count) on `threads`
+// threads, the caller included; blocks are claimed with an atomic counter
+typedef void (*RleBlockFn)(void *ctx, uint32_t block, uint8_t *scratch);
+
+typedef struct {
+    RleBlockFn fn;
+    void *ctx;
+    uint32_t count;
+    uint32_t next;
+    size_t scratch_cap;
+    int status;
+} RleParallel;
+
+static void *rle_parallel_worker(void *arg) {
+    RleParallel *par = arg;
+    uint8_t *scratch = malloc(par->scratch_cap);
+    if (!scratch) {
+        __atomic_store_n(&par->status, RLE_ERR_NOMEM, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    while (1) {
+        uint32_t block = __atomic_fetch_add(&par->next, 1, __ATOMIC_RELAXED);
+        if (block >= par->count) {
+            break;
+        }
+        par->fn(par->ctx, block, scratch);
+    }
+    free(scratch);
+    return NULL;
+}
+
+static int rle_parallel_blocks(int threads, uint32_t count, size_t scratch_cap, RleBlockFn fn, void *ctx) {
+    RleParallel par = {fn, ctx, count, 0, scratch_cap, RLE_OK};
+    pthread_t *workers = calloc((size_t)threads, sizeof(pthread_t));
+    int started = 0;
+    while (workers && started < threads - 1 &&
+           pthread_create(&workers[started], NULL, rle_parallel_worker, &par) == 0) {
+        started++;
+    }
+    rle_parallel_worker(&par);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+    return par.status;
+}
+
+// Zero-copy decoding. The compressed file is mapped and each block is
+// decoded by whichever worker claims it straight into its final place in
+// the output: a caller buffer, or the output file mapped after being
+// pre-sized from the total in the header. No reorder buffer is needed.
+typedef struct {
+    const uint8_t *image;
+    size_t image_size;
+    const RleFile *file;
+    uint8_t *out;
+    int status;
+} RleMapJob;
+
+static void rle_map_block(void *ctx, uint32_t block, uint8_t *scratch) {
+    RleMapJob *job = ctx;
+    const RleBlockInfo *info = &job->file->index[block];
+    int status = RLE_ERR_CORRUPT;
+    if (info->offset <= job->image_size && info->coded_size <= job->image_size - info->offset) {
+        status = rle_decode_block(job->image + info->offset, info->coded_size,
+                                  job->out + (size_t)block * job->file->block_size, info->raw_size, scratch);
+    }
+    if (status != RLE_OK) {
+        __atomic_store_n(&job->status, status, __ATOMIC_RELAXED);
+    }
+}
+
+// Decode a framed file into out (at least file->total_size bytes) using
+// `threads` workers; returns the decoded size or a negative status
+long rle_decompress_to_buffer(RleFile *file, uint8_t *out, size_t cap, int threads) {
+    struct stat st;
+    if (cap < file->total_size) {
+        return RLE_ERR_ARG;
+    }
+    if (file->block_count == 0) {
+        return 0;
+    }
+    if (fstat(file->fd, &st) < 0 || st.st_size == 0) {
+        return RLE_ERR_IO;
+    }
+    void *image = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, file->fd, 0);
+    if (image == MAP_FAILED) {
+        return RLE_ERR_IO;
+    }
+    madvise(image, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    RleMapJob job = {image, (size_t)st.st_size, file, out, RLE_OK};
+    int status = rle_parallel_blocks(threads, file->block_count, rle_encode_bound(file->block_size),
+                                     rle_map_block, &job);
+    munmap(image, (size_t)st.st_size);
+    if (status == RLE_OK) {
+        status = job.status;
+    }
+    return status == RLE_OK ? (long)file->total_size : status;
+}
+
+// Size the output file from the header, map it and decode into it. Sets
+// *mapped to 0, having written nothing, when the output cannot be mapped
+// (a pipe or terminal, say) so the caller can stream instead.
+static int rle_decompress_mapped(RleFile *file, int out, int threads, int *mapped) {
+    *mapped = 0;
+    if (ftruncate(out, (off_t)file->total_size) < 0) {
+        return RLE_ERR_IO;
+    }
+    if (file->total_size == 0) {
+        *mapped = 1;
+        return RLE_OK;
+    }
+    uint8_t *dest = mmap(NULL, file->total_size, PROT_READ | PROT_WRITE, MAP_SHARED, out, 0);
+    if (dest == MAP_FAILED) {
+        return RLE_ERR_IO;
+    }
+    *mapped = 1;
+    long result = rle_decompress_to_buffer(file, dest, file->total_size, threads);
+    if (munmap(dest, file->total_size) < 0 && result >= 0) {
+        result = RLE_ERR_IO;
+    }
+    return result < 0 ? (int)result : RLE_OK;
+}
+
+// Decode a framed file on fd `in` using `threads` workers: in place in
+// the mapped output when map_fd is a read-write descriptor of it, and
+// through the slot pipeline writing to `out` otherwise
+static int rle_decompress_framed(int in, int out, int map_fd, int threads) {
+    RleDecompressJob job;
+    int mapped = 0;
+    job.out = out;
+    int status = rle_load_frame(&job.file, in);
+    int streamed = status == RLE_OK;
+    if (status == RLE_OK && map_fd >= 0) {
+        status = rle_decompress_mapped(&job.file, map_fd, threads, &mapped);
+        streamed = status == RLE_ERR_IO && !mapped;
+    }
+    if (streamed) {
+        status = rle_run_pool(threads, 1, RLE_BLOCK_HEADER_SIZE + rle_encode_bound(job.file.block_size),
+                              job.file.block_size, rle_encode_bound(job.file.block_size), 0,
+                              rle_decompress_fill, rle_decompress_drain, &job);
+    }
+    free(job.file.index);
+    free(job.file.run_start);
+    return status;
+}
+
+// Decode a plain op stream (RLE_MAGIC already consumed) from in to out
+static int rle_decompress_stream(int in, int out) {
+    uint8_t *inbuf = malloc(RLE_BUFFER_SIZE);
+    uint8_t *outbuf = malloc(RLE_BUFFER_SIZE);
+    int status = RLE_OK;
+
+    if (!inbuf || !outbuf) {
+        status = RLE_ERR_NOMEM;
+        goto done;
+    }
+
+    size_t avail = 0;
+    size_t pos = 0;
+    size_t used = 0;
+    int eof = 0;
+    while (1) {
+        // Keep at least one whole op in the input buffer
+        if (!eof && avail - pos < RLE_MAX_OP_SIZE) {
+            memmove(inbuf, inbuf + pos, avail - pos);
+            avail -= pos;
+            pos = 0;
+            ssize_t r = read_full(in, inbuf + avail, RLE_BUFFER_SIZE - avail);
+            if (r < 0) {
+                status = RLE_ERR_IO;
+                goto done;
+            }
+            avail += (size_t)r;
+            eof = avail < RLE_BUFFER_SIZE;
+        }
+        if (pos == avail) {
+            break;
+        }
+
+        int is_run;
+        const uint8_t *data;
+        size_t count;
+        long size = rle_parse_op(inbuf + pos, avail - pos, &is_run, &data, &count);
+        if (size <= 0) {
+            status = RLE_ERR_CORRUPT;
+            goto done;
+        }
+        pos += (size_t)size;
+
+        while (count > 0) {
+            if (used == RLE_BUFFER_SIZE) {
+                if (write_full(out, outbuf, used) < 0) {
+                    status = RLE_ERR_IO;
+                    goto done;
+                }
+                used = 0;
+            }
+            size_t chunk = RLE_BUFFER_SIZE - used;
+            if (chunk > count) {
+                chunk = count;
+            }
+            if (is_run) {
+                memset(outbuf + used, *data, chunk);
+            } else {
+                memcpy(outbuf + used, data, chunk);
+                data += chunk;
+            }
+            used += chunk;
+            count -= chunk;
+        }
+    }
+    if (write_full(out, outbuf, used) < 0) {
+        status = RLE_ERR_IO;
+    }
+
+done:
+    free(inbuf);
+    free(outbuf);
+    return status;
+}
+
+// A read-write descriptor of the output for the mmap decoder, or -1 when
+// the output is not a regular file (a pipe, a terminal) and has to be
+// written as a stream
+static int rle_open_mappable(int out, const char *path) {
+    struct stat st, again;
+    if (fstat(out, &st) < 0 || !S_ISREG(st.st_mode)) {
+        return -1;
+    }
+    int fd = open(path, O_RDWR);
+    if (fd >= 0 && (fstat(fd, &again) < 0 || again.st_dev != st.st_dev || again.st_ino != st.st_ino)) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+// Decompress the input file (framed or plain stream) and write to output file
+int decompress(const char *input, const char *output, int threads) {
+    int in = open(input, O_RDONLY);
+    int out = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int map_fd = -1;
+    int status = RLE_ERR_IO;
+    uint8_t magic[RLE_MAGIC_SIZE];
+
+    if (in >= 0 && out >= 0) {
+        if (read_full(in, magic, RLE_MAGIC_SIZE) != RLE_MAGIC_SIZE) {
+            status = RLE_ERR_FORMAT;
+        } else if (memcmp(magic, RLE_FRAME_MAGIC, RLE_MAGIC_SIZE) == 0) {
+            map_fd = rle_open_mappable(out, output);
+            status = rle_decompress_framed(in, out, map_fd, threads);
+        } else if (memcmp(magic, RLE_MAGIC, RLE_MAGIC_SIZE) == 0) {
+            status = rle_decompress_stream(in, out);
         } else {
-            fprintf(out, "%d%c", count, previous);
-            count = 1;
-            previous = current;
+            status = RLE_ERR_FORMAT;
+        }
+    }
+
+    if (in >= 0) close(in);
+    if (out >= 0) close(out);
+    if (map_fd >= 0) close(map_fd);
+    return rle_report(status, "File decompressed successfully.");
+}
+
+#ifndef RLE_FUZZ
+// Compress or decompress stdin to stdout with the streaming codec; status
+// messages go to stderr so they never mix with the data
+static int rle_pipe(int decode) {
+    uint8_t *inbuf = malloc(RLE_BUFFER_SIZE);
+    uint8_t *outbuf = malloc(rle_encoder_bound(RLE_BUFFER_SIZE));
+    int status = RLE_OK;
+    ssize_t n;
+
+    if (!inbuf || !outbuf) {
+        status = RLE_ERR_NOMEM;
+        goto done;
+    }
+    rle_init_kernels();
+
+    if (!decode) {
+        RleEncoder enc;
+        rle_encoder_init(&enc);
+        while ((n = read(STDIN_FILENO, inbuf, RLE_BUFFER_SIZE)) > 0) {
+            size_t size = rle_encoder_update(&enc, inbuf, (size_t)n, outbuf);
+            if (write_full(STDOUT_FILENO, outbuf, size) < 0) {
+                status = RLE_ERR_IO;
+                goto done;
+            }
+        }
+        size_t size = rle_encoder_finish(&enc, outbuf);
+        if (n < 0 || write_full(STDOUT_FILENO, outbuf, size) < 0) {
+            status = RLE_ERR_IO;
         }
+        goto done;
     }
-    // Write the last sequence
-    if (previous != EOF) {
-        fprintf(out, "%d%c", count, previous);
+
+    RleDecoder dec;
+    rle_decoder_init(&dec);
+    while (status == RLE_OK && (n = read(STDIN_FILENO, inbuf, RLE_BUFFER_SIZE)) > 0) {
+        size_t pos = 0;
+        long produced;
+        do {
+            size_t consumed;
+            produced = rle_decoder_update(&dec, inbuf + pos, (size_t)n - pos, &consumed, outbuf, RLE_BUFFER_SIZE);
+            if (produced < 0) {
+                status = (int)produced;
+                break;
+            }
+            pos += consumed;
+            if (write_full(STDOUT_FILENO, outbuf, (size_t)produced) < 0) {
+                status = RLE_ERR_IO;
+                break;
+            }
+        } while (pos < (size_t)n || produced == RLE_BUFFER_SIZE);
+    }
+    if (status == RLE_OK) {
+        status = n < 0 ? RLE_ERR_IO : rle_decoder_finish(&dec);
     }
 
-    fclose(in);
-    fclose(out);
-    printf("File compressed successfully.\n");
+done:
+    free(inbuf);
+    free(outbuf);
+    if (status != RLE_OK) {
+        fprintf(stderr, "rle: %s\n", status == RLE_ERR_CORRUPT ? "corrupt compressed data"
+                                     : status == RLE_ERR_FORMAT ? "not an RLE stream" : "I/O error");
+    }
+    return status;
 }
 
-// Decompress the input file and write to output file
-void decompress(const char *input, const char *output) {
-    FILE *in = fopen(input, "r");
-    FILE *out = fopen(output, "w");
+// Write len bytes at uncompressed offset `offset` of a framed file to stdout
+static int rle_cat_range(const char *path, uint64_t offset, uint64_t len) {
+    RleFile *file = rle_open(path);
+    uint8_t *buf = malloc(RLE_BUFFER_SIZE);
+    int status = RLE_OK;
 
-    if (!in || !out) {
-        printf("File error.\n");
-        return;
+    if (!file || !buf) {
+        status = file ? RLE_ERR_NOMEM : RLE_ERR_FORMAT;
+    }
+    while (status == RLE_OK && len > 0) {
+        long n = rle_read_range(file, offset, len < RLE_BUFFER_SIZE ? (size_t)len : RLE_BUFFER_SIZE, buf);
+        if (n <= 0) {
+            status = (int)n;
+            break;
+        }
+        if (write_full(STDOUT_FILENO, buf, (size_t)n) < 0) {
+            status = RLE_ERR_IO;
+        }
+        offset += (uint64_t)n;
+        len -= (uint64_t)n;
+    }
+    if (status != RLE_OK) {
+        fprintf(stderr, "rle: %s\n", status == RLE_ERR_CORRUPT ? "corrupt compressed data"
+                                     : status == RLE_ERR_FORMAT ? "not a framed RLE file" : "I/O error");
+    }
+    free(buf);
+    rle_close(file);
+    return status;
+}
+
+// Number of worker threads to use when none is given
+static int default_threads(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+// Benchmark: synthetic corpora coded in memory block by block, reporting
+// the framed size ratio and compress/decompress throughput per thread
+// count. Every run is checked to round-trip.
+enum { CORPUS_SAME, CORPUS_RANDOM, CORPUS_TEXT, CORPUS_SPARSE, CORPUS_TELEMETRY, CORPUS_COUNT };
+
+static const char *corpus_names[CORPUS_COUNT] = {"all-same", "random", "text", "sparse-binary", "telemetry"};
+
+// Small xorshift generator so corpora are reproducible
+static uint64_t bench_rand(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Fill buf with n bytes of the given corpus
+static void bench_corpus(int kind, uint8_t *buf, size_t n) {
+    static const char *words[] = {"the", "error", "request", "value", "of", "server", "and", "timeout",
+                                  "user", "connection", "a", "returned", "data", "in", "file", "retry"};
+    uint64_t state = 0x9E3779B97F4A7C15ull + (uint64_t)kind;
+    size_t i = 0;
+
+    while (i < n) {
+        uint64_t r = bench_rand(&state);
+        switch (kind) {
+            case CORPUS_SAME:
+                buf[i++] = 'A';
+                break;
+            case CORPUS_RANDOM:
+                for (int b = 0; b < 8 && i < n; b++) {
+                    buf[i++] = (uint8_t)(r >> (8 * b));
+                }
+                break;
+            case CORPUS_TEXT: {
+                const char *w = words[r % 16];
+                while (*w && i < n) {
+                    buf[i++] = (uint8_t)*w++;
+                }
+                if (i < n) {
+                    buf[i++] = (r >> 8) % 12 == 0 ? '\n' : ' ';
+                }
+                break;
+            }
+            case CORPUS_SPARSE:
+                buf[i++] = (r & 0x3F) == 0 ? (uint8_t)(r >> 8) : 0;
+                break;
+            default: {
+                // Fixed-width records: a slowly changing timestamp, a sensor id,
+                // a reading, then zero padding of varying length
+                char record[64];
+                int len = snprintf(record, sizeof(record), "%010llu,%02u,%05u,",
+                                   (unsigned long long)(i / 4096), (unsigned)(r % 8), (unsigned)((r >> 8) % 100));
+                for (int b = 0; b < len && i < n; b++) {
+                    buf[i++] = (uint8_t)record[b];
+                }
+                size_t pad = 16 + (size_t)((r >> 24) % 48);
+                for (size_t b = 0; b < pad && i < n; b++) {
+                    buf[i++] = 0;
+                }
+                break;
+            }
+        }
+    }
+}
+
+typedef struct {
+    const uint8_t *raw;
+    size_t raw_size;
+    size_t block_size;
+    uint8_t *coded;
+    size_t coded_stride;
+    size_t *coded_size;
+    uint8_t *out;
+    int status;
+} RleBenchJob;
+
+static void bench_compress_block(void *ctx, uint32_t block, uint8_t *scratch) {
+    RleBenchJob *job = ctx;
+    size_t start = (size_t)block * job->block_size;
+    size_t n = job->raw_size - start < job->block_size ? job->raw_size - start : job->block_size;
+    job->coded_size[block] = rle_encode_block(job->raw + start, n, job->coded + (size_t)block * job->coded_stride, scratch);
+}
+
+static void bench_decompress_block(void *ctx, uint32_t block, uint8_t *scratch) {
+    RleBenchJob *job = ctx;
+    size_t start = (size_t)block * job->block_size;
+    size_t n = job->raw_size - start < job->block_size ? job->raw_size - start : job->block_size;
+    if (rle_decode_block(job->coded + (size_t)block * job->coded_stride, job->coded_size[block],
+                         job->out + start, n, scratch) != RLE_OK) {
+        __atomic_store_n(&job->status, RLE_ERR_CORRUPT, __ATOMIC_RELAXED);
+    }
+}
+
+// Monotonic clock in seconds
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Repeat one parallel pass until it has run for a measurable time; returns MB/s
+static double bench_pass(int threads, uint32_t blocks, size_t scratch_cap, RleBlockFn fn, RleBenchJob *job) {
+    double start = bench_now();
+    double elapsed;
+    int rounds = 0;
+    do {
+        rle_parallel_blocks(threads, blocks, scratch_cap, fn, job);
+        rounds++;
+        elapsed = bench_now() - start;
+    } while (elapsed < 0.2);
+    return (double)job->raw_size * rounds / elapsed / 1e6;
+}
+
+// Run every corpus at 1, 2, 4 ... max_threads threads
+static int rle_benchmark(size_t size, int max_threads, size_t block_size) {
+    uint32_t blocks = (uint32_t)((size + block_size - 1) / block_size);
+    size_t stride = RLE_BLOCK_HEADER_SIZE + rle_encode_bound(block_size);
+    RleBenchJob job;
+    int failed = 0;
+
+    memset(&job, 0, sizeof(job));
+    job.raw_size = size;
+    job.block_size = block_size;
+    job.coded_stride = stride;
+    uint8_t *raw = malloc(size);
+    job.coded = malloc((size_t)blocks * stride);
+    job.coded_size = calloc(blocks, sizeof(size_t));
+    job.out = malloc(size);
+    job.raw = raw;
+    if (!raw || !job.coded || !job.coded_size || !job.out) {
+        printf("Out of memory.\n");
+        failed = 1;
+        goto done;
+    }
+    rle_init_kernels();
+
+    printf("%-14s %8s %8s %8s %14s %14s\n", "corpus", "MB", "ratio", "threads", "compress MB/s", "decompress MB/s");
+    for (int kind = 0; kind < CORPUS_COUNT; kind++) {
+        bench_corpus(kind, raw, size);
+        for (int threads = 1; ; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+            double c = bench_pass(threads, blocks, rle_encode_bound(block_size), bench_compress_block, &job);
+            memset(job.out, 0, size);
+            job.status = RLE_OK;
+            double d = bench_pass(threads, blocks, rle_encode_bound(block_size), bench_decompress_block, &job);
+
+            size_t coded = RLE_FRAME_HEADER_SIZE + (size_t)blocks * RLE_INDEX_ENTRY_SIZE;
+            for (uint32_t b = 0; b < blocks; b++) {
+                coded += job.coded_size[b];
+            }
+            int ok = job.status == RLE_OK && memcmp(raw, job.out, size) == 0;
+            printf("%-14s %8.1f %8.3f %8d %14.1f %14.1f%s\n", corpus_names[kind], (double)size / 1e6,
+                   (double)coded / (double)(size ? size : 1), threads, c, d, ok ? "" : "  ROUND-TRIP FAILED");
+            failed |= !ok;
+            if (threads >= max_threads) {
+                break;
+            }
+        }
+    }
+
+done:
+    free(raw);
+    free(job.coded);
+    free(job.coded_size);
+    free(job.out);
+    return failed ? 1 : 0;
+}
+
+#endif
+
+#ifdef RLE_FUZZ
+// Build a framed file of data[0..size) in memory, blocks of block_size
+// bytes, the way compress() lays it out; returns its size
+static size_t rle_fuzz_frame(const uint8_t *data, size_t size, uint32_t block_size, uint8_t *frame, uint8_t *scratch) {
+    uint32_t count = (uint32_t)((size + block_size - 1) / block_size);
+    size_t offset = RLE_FRAME_HEADER_SIZE;
+
+    for (uint32_t i = 0; i < count; i++) {
+        size_t raw = size - (size_t)i * block_size < block_size ? size - (size_t)i * block_size : block_size;
+        offset += rle_encode_block(data + (size_t)i * block_size, raw, frame + offset, scratch);
+    }
+    memset(frame, 0, RLE_FRAME_HEADER_SIZE);
+    memcpy(frame, RLE_FRAME_MAGIC, RLE_MAGIC_SIZE);
+    put_u32(frame + 4, block_size);
+    put_u32(frame + 8, count);
+    put_u64(frame + 12, size);
+    put_u64(frame + 20, offset);
+    size_t block_offset = RLE_FRAME_HEADER_SIZE;
+    for (uint32_t i = 0; i < count; i++) {
+        size_t raw = size - (size_t)i * block_size < block_size ? size - (size_t)i * block_size : block_size;
+        size_t coded = RLE_BLOCK_HEADER_SIZE + get_u32(frame + block_offset + 5);
+        uint8_t *entry = frame + offset + (size_t)i * RLE_INDEX_ENTRY_SIZE;
+        put_u64(entry, block_offset);
+        put_u32(entry + 8, (uint32_t)coded);
+        put_u32(entry + 12, (uint32_t)raw);
+        block_offset += coded;
+    }
+    return offset + (size_t)count * RLE_INDEX_ENTRY_SIZE;
+}
+
+// Load frame[0..n) through a memory file and decode it every way a framed
+// file can be read, including the compressed-domain scan; returns the
+// decoded size or a negative status
+static long rle_fuzz_load(const uint8_t *frame, size_t n, uint8_t *out, size_t cap) {
+    RleFile file;
+    RleScan scan;
+    char path[64];
+    uint64_t hist[256] = {0};
+    int fd = memfd_create("rle-fuzz", 0);
+    if (fd < 0 || write_full(fd, frame, n) < 0) {
+        if (fd >= 0) close(fd);
+        return RLE_ERR_IO;
+    }
+    long result = rle_load_frame(&file, fd);
+    if (result == RLE_OK) {
+        result = file.total_size > cap ? RLE_ERR_ARG : rle_decompress_to_buffer(&file, out, cap, 2);
+        for (uint32_t i = 0; i < file.block_count && result >= 0; i++) {
+            size_t at = (size_t)i * file.block_size;
+            if (rle_read_block(&file, i, out + at, cap - at) < 0) {
+                result = RLE_ERR_CORRUPT;
+            }
+        }
+    }
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+    if (rle_scan_open(&scan, path) == RLE_OK) {
+        long long total = rle_scan_histogram(&scan, hist);
+        if (result >= 0 && total != result) {
+            abort();
+        }
+        rle_scan_close(&scan);
+    }
+    free(file.index);
+    free(file.run_start);
+    close(fd);
+    return result;
+}
+
+// libFuzzer round-trip harness; build with
+//   clang -O1 -g -DRLE_FUZZ -fsanitize=fuzzer,address -pthread rle.c
+// Checks every codec path, the framed container included, decodes back
+// to the input and that decoding arbitrary bytes fails cleanly.
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    size_t bound = rle_encoder_bound(size) + RLE_BLOCK_HEADER_SIZE;
+    uint8_t *coded = malloc(bound);
+    uint8_t *scratch = malloc(bound);
+    uint8_t *out = malloc(size + 1);
+
+    rle_init_kernels();
+
+    // Plain op stream
+    size_t n = rle_encode(data, size, coded);
+    if (rle_decode(coded, n, out, size) != (long)size || memcmp(out, data, size) != 0) {
+        abort();
+    }
+
+    // Adaptive block
+    n = rle_encode_block(data, size, coded, scratch);
+    if (rle_decode_block(coded, n, out, size, scratch) != RLE_OK || memcmp(out, data, size) != 0) {
+        abort();
+    }
+
+    // Streaming codec, chunked by the first input byte
+    size_t chunk = size ? (size_t)data[0] % 61 + 1 : 1;
+    RleEncoder enc;
+    rle_encoder_init(&enc);
+    n = 0;
+    for (size_t i = 0; i < size; i += chunk) {
+        n += rle_encoder_update(&enc, data + i, size - i < chunk ? size - i : chunk, coded + n);
+    }
+    n += rle_encoder_finish(&enc, coded + n);
+    RleDecoder dec;
+    rle_decoder_init(&dec);
+    size_t pos = 0;
+    size_t got = 0;
+    while (pos < n || got < size) {
+        size_t consumed;
+        long produced = rle_decoder_update(&dec, coded + pos, n - pos, &consumed, out + got, size - got < 7 ? size - got : 7);
+        if (produced < 0 || (produced == 0 && consumed == 0)) {
+            abort();
+        }
+        pos += consumed;
+        got += (size_t)produced;
+    }
+    if (got != size || rle_decoder_finish(&dec) != RLE_OK || memcmp(out, data, size) != 0) {
+        abort();
+    }
+
+    // Compressed-domain queries agree with the bytes; a split of the input
+    // joined back together decodes to the input and compares equal to it
+    uint64_t hist[256] = {0};
+    size_t half = size ? (size_t)data[size - 1] % (size + 1) : 0;
+    n = rle_encode(data, size, coded);
+    if (rle_ops_histogram(coded, n, hist) != (long long)size ||
+        rle_ops_find(coded, n, 0) != (memchr(data, 0, size) ? (uint8_t *)memchr(data, 0, size) - data : -1)) {
+        abort();
+    }
+    uint8_t *halves = malloc(rle_encode_bound(half) + rle_encode_bound(size - half));
+    uint8_t *joined = malloc(rle_concat_bound(rle_encode_bound(half), rle_encode_bound(size - half)));
+    size_t na = rle_encode(data, half, halves);
+    size_t nb = rle_encode(data + half, size - half, halves + na);
+    long nj = rle_ops_concat(halves, na, halves + na, nb, joined);
+    if (nj < 0 || rle_decode(joined, (size_t)nj, out, size) != (long)size || memcmp(out, data, size) != 0 ||
+        rle_ops_equal(joined, (size_t)nj, coded, n) != 1) {
+        abort();
+    }
+    free(halves);
+    free(joined);
+
+    // Framed container: a frame of the input decodes back to it, the raw
+    // bytes and the frame with one byte altered are rejected or decoded
+    // without writing past the output
+    uint32_t frame_block = size ? (uint32_t)data[0] % 64 + 1 : 1;
+    size_t frame_cap = RLE_FRAME_HEADER_SIZE + (size / frame_block + 1) * (RLE_BLOCK_HEADER_SIZE +
+                       rle_encode_bound(frame_block) + RLE_INDEX_ENTRY_SIZE);
+    uint8_t *frame = malloc(frame_cap);
+    size_t frame_size = rle_fuzz_frame(data, size, frame_block, frame, scratch);
+    if (rle_fuzz_load(frame, frame_size, out, size) != (long)size || memcmp(out, data, size) != 0) {
+        abort();
     }
+    if (size >= 3) {
+        frame[((size_t)data[1] << 8 | data[2]) % frame_size] ^= data[size - 1] | 1;
+        rle_fuzz_load(frame, frame_size, out, size);
+    }
+    rle_fuzz_load(data, size, out, size);
+    free(frame);
+
+    // Garbage in must be rejected or decoded without overrunning out
+    rle_decode(data, size, out, size);
+    rle_decode_block(data, size, out, size, scratch);
+    huf_decode(data, size, scratch, bound);
+    rle_ops_histogram(data, size, hist);
+    rle_ops_equal(data, size, coded, n);
+
+    free(coded);
+    free(scratch);
+    free(out);
+    return 0;
+}
+#else
+// Print command line usage
+static void usage(const char *prog) {
+    printf("Usage: %s -c [-t threads] [-b block_kb] [-k run_interval] input output\n", prog);
+    printf("       %s -d [-t threads] input output\n", prog);
+    printf("       %s -r input offset length   (range to stdout)\n", prog);
+    printf("       %s -H input                 (length and byte histogram)\n", prog);
+    printf("       %s -F byte input            (offset of first byte)\n", prog);
+    printf("       %s -E input1 input2         (compare contents)\n", prog);
+    printf("       %s -J input1 input2 output  (join plain streams)\n", prog);
+    printf("       %s -B [-s size_mb] [-t max_threads] [-b block_kb]   (benchmark)\n", prog);
+    printf("       %s -c|-d      (stream stdin to stdout)\n", prog);
+    printf("       %s            (interactive)\n", prog);
+}
 
-    int count;
-    char ch;
+// Non-interactive entry point
+static int run_cli(int argc, char *argv[]) {
+    int mode = 0;
+    int threads = default_threads();
+    size_t block_size = RLE_DEFAULT_BLOCK_SIZE;
+    uint32_t run_interval = 0;
+    size_t bench_size = 64u << 20;
+    int find_byte = 0;
+    int opt;
 
-    while (fscanf(in, "%d%c", &count, &ch) == 2) {
-        for (int i = 0; i < count; i++) {
-            fputc(ch, out);
+    while ((opt = getopt(argc, argv, "cdrBHEJF:t:b:k:s:")) != -1) {
+        switch (opt) {
+            case 'c':
+            case 'd':
+            case 'r':
+            case 'B':
+            case 'H':
+            case 'E':
+            case 'J':
+                mode = opt;
+                break;
+            case 'F':
+                mode = opt;
+                find_byte = (int)strtol(optarg, NULL, 0);
+                break;
+            case 's':
+                bench_size = (size_t)strtoul(optarg, NULL, 10) << 20;
+                break;
+            case 'k':
+                run_interval = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+            case 't':
+                threads = atoi(optarg);
+                break;
+            case 'b':
+                block_size = (size_t)strtoul(optarg, NULL, 10) * 1024;
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
         }
     }
+    if (mode == 'B' && argc == optind && threads >= 1 && block_size > 0 && block_size <= RLE_MAX_BLOCK_SIZE) {
+        return rle_benchmark(bench_size, threads, block_size);
+    }
+    if (mode == 'r' && argc - optind == 3) {
+        return rle_cat_range(argv[optind], strtoull(argv[optind + 1], NULL, 10),
+                             strtoull(argv[optind + 2], NULL, 10)) == RLE_OK ? 0 : 1;
+    }
+    if (mode == 'H' && argc - optind == 1) {
+        return rle_print_histogram(argv[optind]) == RLE_OK ? 0 : 1;
+    }
+    if (mode == 'F' && argc - optind == 1 && find_byte >= 0 && find_byte < 256) {
+        return rle_print_find(argv[optind], (uint8_t)find_byte) == RLE_OK ? 0 : 1;
+    }
+    if (mode == 'E' && argc - optind == 2) {
+        return rle_print_equal(argv[optind], argv[optind + 1]) == RLE_OK ? 0 : 1;
+    }
+    if (mode == 'J' && argc - optind == 3) {
+        return rle_join(argv[optind], argv[optind + 1], argv[optind + 2]) == RLE_OK ? 0 : 1;
+    }
+    if ((mode == 'c' || mode == 'd') && argc == optind) {
+        return rle_pipe(mode == 'd') == RLE_OK ? 0 : 1;
+    }
+    if (!mode || (mode != 'c' && mode != 'd') || argc - optind != 2 || threads < 1 || block_size == 0 || block_size > RLE_MAX_BLOCK_SIZE) {
+        usage(argv[0]);
+        return 1;
+    }
 
-    fclose(in);
-    fclose(out);
-    printf("File decompressed successfully.\n");
+    int status = mode == 'c' ? compress(argv[optind], argv[optind + 1], threads, block_size, run_interval)
+                             : decompress(argv[optind], argv[optind + 1], threads);
+    return status == RLE_OK ? 0 : 1;
 }
 
 // Main function to choose mode
-int main() {
+int main(int argc, char *argv[]) {
     int choice;
-    char inputFile[100], outputFile[100];
+    char inputFile[256], outputFile[256];
+
+    if (argc > 1) {
+        return run_cli(argc, argv);
+    }
 
     printf("1. Compress a file\n");
     printf("2. Decompress a file\n");
@@ -69,17 +3067,18 @@ int main() {
     scanf("%d", &choice);
 
     printf("Enter input file name: ");
-    scanf("%s", inputFile);
+    scanf("%255s", inputFile);
     printf("Enter output file name: ");
-    scanf("%s", outputFile);
+    scanf("%255s", outputFile);
 
     if (choice == 1) {
-        compress(inputFile, outputFile);
+        compress(inputFile, outputFile, default_threads(), RLE_DEFAULT_BLOCK_SIZE, 0);
     } else if (choice == 2) {
-        decompress(inputFile, outputFile);
+        decompress(inputFile, outputFile, default_threads());
     } else {
         printf("Invalid choice.\n");
     }
 
     return 0;
 }
+#endif